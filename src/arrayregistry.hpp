@@ -0,0 +1,118 @@
+#ifndef ARRAYREGISTRY_HPP
+#define ARRAYREGISTRY_HPP
+
+#include <cstdint>
+#include <vector>
+
+extern "C" {
+#include "glk.h"
+#include "gi_dispa.h"
+}
+
+namespace Glk {
+    /// The dispatch rocks of the retained arrays, keyed by the array's address. Arrays are registered and
+    ///   unregistered around every buffered read, line input and memory stream, so this is an open addressing hash
+    ///   table in one flat vector: no allocation per entry, and unregistering finds and erases in a single probe
+    ///   sequence. Deleted entries are filled by shifting the rest of their run back, so no tombstones pile up.
+    class ArrayRegistry {
+            struct Entry {
+                void* key; /* null for empty entries */
+                gidispatch_rock_t rock;
+            };
+
+            static constexpr std::size_t INITIAL_CAPACITY = 16;
+
+        public:
+            ArrayRegistry() : m_Entries(INITIAL_CAPACITY, Entry{nullptr, {}}), m_Size{0} {}
+
+
+            [[nodiscard]] inline bool empty() const {
+                return m_Size == 0;
+            }
+
+            [[nodiscard]] inline std::size_t size() const {
+                return m_Size;
+            }
+
+            /// Replaces the rock of a key that is already registered.
+            void insert(void* key, gidispatch_rock_t rock) {
+                /* kept at most half full, so probe runs stay short */
+                if(2 * (m_Size + 1) > m_Entries.size())
+                    rehash(2 * m_Entries.size());
+
+                std::size_t index = find(key);
+                if(!m_Entries[index].key) {
+                    m_Entries[index].key = key;
+                    m_Size++;
+                }
+                m_Entries[index].rock = rock;
+            }
+
+            /// Removes the key, returning false when it was not registered.
+            bool take(void* key, gidispatch_rock_t& rock) {
+                std::size_t index = find(key);
+                if(!m_Entries[index].key)
+                    return false;
+
+                rock = m_Entries[index].rock;
+                erase(index);
+                m_Size--;
+
+                return true;
+            }
+
+        private:
+            [[nodiscard]] inline std::size_t mask() const {
+                return m_Entries.size() - 1;
+            }
+
+            [[nodiscard]] inline std::size_t home(const void* key) const {
+                /* arrays are at least word aligned, so the low bits carry nothing */
+                auto bits = std::uint64_t(reinterpret_cast<std::uintptr_t>(key) >> 3);
+                return std::size_t((bits * 0x9e3779b97f4a7c15ull) >> 32) & mask();
+            }
+
+            /// The entry holding key, or the empty entry where it would go.
+            [[nodiscard]] std::size_t find(const void* key) const {
+                std::size_t index = home(key);
+                while(m_Entries[index].key && m_Entries[index].key != key)
+                    index = (index + 1) & mask();
+
+                return index;
+            }
+
+            void erase(std::size_t hole) {
+                std::size_t index = hole;
+
+                for(;;) {
+                    index = (index + 1) & mask();
+                    if(!m_Entries[index].key)
+                        break;
+
+                    /* an entry can move back into the hole only if that does not put it before its home */
+                    std::size_t distance = (index - home(m_Entries[index].key)) & mask();
+                    if(distance >= ((index - hole) & mask())) {
+                        m_Entries[hole] = m_Entries[index];
+                        hole = index;
+                    }
+                }
+
+                m_Entries[hole].key = nullptr;
+            }
+
+            void rehash(std::size_t capacity) {
+                std::vector<Entry> old(capacity, Entry{nullptr, {}});
+                old.swap(m_Entries);
+
+                for(const Entry& entry : old)
+                    if(entry.key)
+                        m_Entries[find(entry.key)] = entry;
+            }
+
+
+            std::vector<Entry> m_Entries; /* the capacity is always a power of two */
+            std::size_t m_Size;
+    };
+}
+
+#endif //ARRAYREGISTRY_HPP
@@ -5,7 +5,12 @@
 #include <mutex>
 #include <unordered_map>
 
+#include "resourcepack.hpp"
+
 namespace {
+    /* Loading a chunk seeks and reads the one stream the blorb file is open on, and chunks are loaded from the glk
+     * thread, the event thread and the mixer, so every load and unload happens under the map's lock. There is at most
+     * one live Data per chunk, since they would all share the one buffer giblorb keeps for it. */
     class SafeMap {
       public:
         [[nodiscard]] std::shared_ptr<Glk::Blorb::Chunk::Data> get(glui32 number) const noexcept {
@@ -16,12 +21,53 @@ namespace {
             else
                 return {};
         }
-        void set(glui32 number, std::weak_ptr<Glk::Blorb::Chunk::Data> ptr) noexcept {
+
+        [[nodiscard]] std::shared_ptr<Glk::Blorb::Chunk::Data> load(glui32 number) noexcept {
             std::lock_guard lock{m_mutex};
-            m_map.try_emplace(number, std::move(ptr));
+
+            if(auto it = m_map.find(number); it != m_map.end())
+                if(auto ptr = it->second.lock())
+                    return ptr;
+
+            giblorb_map_t* rmap;
+            if(!(rmap = giblorb_get_resource_map()))
+                return {};
+
+            giblorb_result_t res;
+            if(giblorb_load_chunk_by_number(rmap, giblorb_method_Memory, &res, number) != giblorb_err_None)
+                return {};
+
+            std::shared_ptr<Glk::Blorb::Chunk::Data> ptr(
+                    new Glk::Blorb::Chunk::Data{static_cast<Glk::Blorb::Chunk::Type>(res.chunktype), res.chunknum,
+                                                res.length, res.data.ptr},
+                    [this](Glk::Blorb::Chunk::Data* data) { unload(data); });
+            m_map.insert_or_assign(number, ptr);
+            return ptr;
+        }
+
+        void lock() noexcept {
+            m_mutex.lock();
+        }
+
+        void unlock() noexcept {
+            m_mutex.unlock();
         }
 
       private:
+        void unload(Glk::Blorb::Chunk::Data* data) noexcept {
+            std::lock_guard lock{m_mutex};
+
+            /* the chunk may have been loaded again between this Data expiring and getting here, in which case the
+             * new Data owns the buffer now */
+            if(auto it = m_map.find(data->number); it != m_map.end() && it->second.expired()) {
+                giblorb_unload_chunk(giblorb_get_resource_map(), data->number);
+                m_map.erase(it);
+            }
+
+            delete data;
+        }
+
+
         mutable std::mutex m_mutex;
         std::unordered_map<glui32, std::weak_ptr<Glk::Blorb::Chunk::Data>> m_map;
     };
@@ -29,6 +75,15 @@ namespace {
     SafeMap s_chunk_map;
 }
 
+/* giblorb_load_image_info() loads chunks of its own, so it takes the same lock */
+extern "C" void qglk_blorb_lock(void) {
+    s_chunk_map.lock();
+}
+
+extern "C" void qglk_blorb_unlock(void) {
+    s_chunk_map.unlock();
+}
+
 bool Glk::Blorb::isChunkLoaded(glui32 chunknum) noexcept {
     return static_cast<bool>(s_chunk_map.get(chunknum));
 }
@@ -71,26 +126,25 @@ Glk::Blorb::Chunk Glk::Blorb::loadChunkByType(glui32 chunktype, glui32 count) no
 }
 
 Glk::Blorb::Chunk Glk::Blorb::Chunk::loadByNumber(glui32 number) noexcept {
-    constexpr auto fn_deleter = [](Chunk::Data* ptr) -> void {
-      if(!ptr)
-          return;
+    return Chunk{s_chunk_map.load(number)};
+}
 
-      giblorb_unload_chunk(giblorb_get_resource_map(), ptr->number);
-      delete ptr;
-    };
+std::uint64_t Glk::Blorb::indexFingerprint(giblorb_map_t* map) noexcept {
+    IndexFingerprint fingerprint;
 
-    if(auto ptr = s_chunk_map.get(number))
-        return Chunk{std::move(ptr)};
+    for(glui32 usage : {giblorb_ID_Pict, giblorb_ID_Snd, giblorb_ID_Exec}) {
+        glui32 num, min, max;
+        if(giblorb_count_resources(map, usage, &num, &min, &max) != giblorb_err_None || num == 0)
+            continue;
 
-    giblorb_map_t* rmap;
-    if(!(rmap = giblorb_get_resource_map()))
-        return {};
+        for(glui32 resnum = min; resnum <= max; resnum++) {
+            giblorb_result_t res;
+            if(giblorb_load_resource(map, giblorb_method_DontLoad, &res, usage, resnum) != giblorb_err_None)
+                continue;
 
-    giblorb_result_t res;
-    if(giblorb_load_chunk_by_number(rmap, giblorb_method_Memory, &res, number) != giblorb_err_None)
-        return {};
+            fingerprint.add(usage, resnum, res.chunktype, res.length);
+        }
+    }
 
-    std::shared_ptr<Data> ptr(new Data{static_cast<Type>(res.chunktype), res.chunknum, res.length, res.data.ptr}, fn_deleter);
-    s_chunk_map.set(number, ptr);
-    return Chunk{std::move(ptr)};
+    return fingerprint.value();
 }
@@ -1,6 +1,8 @@
 #ifndef CHUNK_HPP
 #define CHUNK_HPP
 
+#include <cstdint>
+
 #include <memory>
 
 #include "glk.hpp"
@@ -74,6 +76,9 @@ namespace Glk {
         }
         Chunk loadChunkByType(glui32 chunktype, glui32 count) noexcept;
         [[deprecated]] bool isChunkLoaded(glui32 chunknum) noexcept;
+
+        /* identifies a blorb by its resource index, so caches keyed on it survive the game file being moved around */
+        std::uint64_t indexFingerprint(giblorb_map_t* map) noexcept;
     }
 }
 
@@ -0,0 +1,238 @@
+#include "prefetcher.hpp"
+
+#include <algorithm>
+#include <fstream>
+
+#include <QImage>
+#include <QRunnable>
+#include <QStandardPaths>
+
+#include <fmt/format.h>
+
+#include "qglk.hpp"
+
+#include "log/log.hpp"
+
+namespace {
+    class ImageDecodeTask : public QRunnable {
+        public:
+            ImageDecodeTask(const char* data, glui32 length, std::function<void(QImage)> callback)
+                : mp_Data{data}, m_Length{length}, m_Callback{std::move(callback)} {}
+
+            void run() override {
+                m_Callback(QImage::fromData(reinterpret_cast<const uchar*>(mp_Data), int(m_Length)));
+            }
+
+        private:
+            const char* mp_Data;
+            glui32 m_Length;
+            std::function<void(QImage)> m_Callback;
+    };
+}
+
+Glk::Blorb::Prefetcher::Prefetcher() {
+    m_DecodePool.setMaxThreadCount(1);
+}
+
+Glk::Blorb::Prefetcher::~Prefetcher() {
+    m_DecodePool.waitForDone();
+
+    std::lock_guard lock{m_Mutex};
+    saveHistory();
+}
+
+void Glk::Blorb::Prefetcher::hint(ResourceUsage usage, glui32 number, bool load) {
+    std::lock_guard lock{m_Mutex};
+
+    Resource res{usage, number};
+    if(load) {
+        m_PinnedChunks.try_emplace(res.key());
+        m_Warmed.erase(res.key());
+        m_Queue.push_front(res);
+    } else {
+        m_PinnedChunks.erase(res.key());
+    }
+}
+
+bool Glk::Blorb::Prefetcher::prefetchNext() {
+    assert(onGlkThread());
+
+    Resource res{};
+
+    {
+        std::lock_guard lock{m_Mutex};
+
+        releaseFinishedDecodes();
+
+        if(!setupResourceMap())
+            return false;
+
+        do {
+            if(m_Queue.empty())
+                return false;
+
+            res = m_Queue.front();
+            m_Queue.pop_front();
+        } while(!m_Warmed.insert(res.key()).second);
+    }
+
+    /* the lock is not held while the chunk comes off the disk, recordAccess is also called on the event thread */
+    warm(res);
+    return true;
+}
+
+void Glk::Blorb::Prefetcher::recordAccess(ResourceUsage usage, glui32 number) {
+    std::lock_guard lock{m_Mutex};
+
+    if(!setupResourceMap())
+        return;
+
+    Resource res{usage, number};
+    if(m_SessionSeen.insert(res.key()).second)
+        m_SessionOrder.push_back(res);
+
+    m_Warmed.insert(res.key());
+    enqueuePredictions(res);
+}
+
+void Glk::Blorb::Prefetcher::enqueuePredictions(const Resource& res) {
+    if(auto it = m_HistoryIndex.find(res.key()); it != m_HistoryIndex.end()) {
+        for(size_t ii = it->second + 1; ii < std::min(m_History.size(), it->second + 1 + LOOKAHEAD); ii++) {
+            if(m_Warmed.count(m_History[ii].key()) == 0)
+                m_Queue.push_back(m_History[ii]);
+        }
+    } else {
+        /* nothing learnt about this resource yet, so we guess the game walks the blorb in order */
+        for(glui32 ii = 1; ii <= LOOKAHEAD; ii++) {
+            giblorb_result_t blorbRes;
+            Resource next{res.usage, res.number + ii};
+            if(m_Warmed.count(next.key()) == 0 &&
+               giblorb_load_resource(mp_Map, giblorb_method_DontLoad, &blorbRes, glui32(next.usage), next.number) == giblorb_err_None)
+                m_Queue.push_back(next);
+        }
+    }
+}
+
+void Glk::Blorb::Prefetcher::loadHistory() {
+    m_History.clear();
+    m_HistoryIndex.clear();
+
+    std::ifstream file{m_HistoryPath};
+    if(!file)
+        return;
+
+    char kind;
+    glui32 number;
+    while(m_History.size() < MAX_HISTORY && file >> kind >> number) {
+        Resource res{kind == 'P' ? ResourceUsage::Picture : ResourceUsage::Sound, number};
+        if(m_HistoryIndex.try_emplace(res.key(), m_History.size()).second)
+            m_History.push_back(res);
+    }
+
+    SPDLOG_DEBUG("Loaded {} entries of resource access history from {}", m_History.size(), m_HistoryPath);
+}
+
+void Glk::Blorb::Prefetcher::releaseFinishedDecodes() {
+    for(std::uint64_t key : m_FinishedDecodes)
+        m_DecodingChunks.erase(key);
+
+    m_FinishedDecodes.clear();
+}
+
+void Glk::Blorb::Prefetcher::saveHistory() const {
+    if(m_HistoryPath.empty() || m_SessionOrder.empty())
+        return;
+
+    /* slot what we saw this session in after whatever preceded it, keeping the order learnt in earlier runs */
+    std::vector<Resource> merged = m_History;
+    for(size_t ii = 0; ii < m_SessionOrder.size(); ii++) {
+        if(std::find(merged.begin(), merged.end(), m_SessionOrder[ii]) != merged.end())
+            continue;
+
+        auto pos = merged.begin();
+        if(ii != 0) {
+            pos = std::find(merged.begin(), merged.end(), m_SessionOrder[ii - 1]);
+            if(pos != merged.end())
+                ++pos;
+        }
+
+        merged.insert(pos, m_SessionOrder[ii]);
+    }
+
+    if(merged.size() > MAX_HISTORY)
+        merged.resize(MAX_HISTORY);
+
+    std::error_code ec;
+    std::filesystem::create_directories(m_HistoryPath.parent_path(), ec);
+    if(ec) {
+        spdlog::warn("Failed to create resource history directory {}: {}", m_HistoryPath.parent_path(), ec.message());
+        return;
+    }
+
+    std::ofstream file{m_HistoryPath, std::ios_base::out | std::ios_base::trunc};
+    for(const auto& res : merged)
+        file << (res.usage == ResourceUsage::Picture ? 'P' : 'S') << ' ' << res.number << '\n';
+
+    if(!file)
+        spdlog::warn("Failed to save resource history to {}", m_HistoryPath);
+}
+
+bool Glk::Blorb::Prefetcher::setupResourceMap() {
+    giblorb_map_t* map = giblorb_get_resource_map();
+    if(!map)
+        return false;
+
+    if(map == mp_Map)
+        return true;
+
+    mp_Map = map;
+
+    QString cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if(!cacheDir.isEmpty()) {
+        m_HistoryPath = std::filesystem::path{cacheDir.toStdString()} / "prefetch" /
+                        fmt::format("{:016x}.txt", indexFingerprint(mp_Map));
+        loadHistory();
+    }
+
+    for(size_t ii = 0; ii < std::min(m_History.size(), LOOKAHEAD); ii++)
+        m_Queue.push_back(m_History[ii]);
+
+    return true;
+}
+
+void Glk::Blorb::Prefetcher::warm(const Resource& res) {
+    /* anything in the resource pack is already decoded and mapped in */
+    const ResourcePack& pack = QGlk::getMainWindow().resourcePack();
+    if(res.usage == ResourceUsage::Picture ? !pack.image(res.number).isNull() : !pack.sound(res.number).isEmpty())
+        return;
+
+    Chunk chunk = loadResource(res.number, res.usage);
+    if(!chunk.isValid())
+        return;
+
+    std::lock_guard lock{m_Mutex};
+
+    if(auto it = m_PinnedChunks.find(res.key()); it != m_PinnedChunks.end()) {
+        it->second = chunk;
+    } else if(res.usage == ResourceUsage::Sound) {
+        m_WarmChunks.push_back(chunk);
+        if(m_WarmChunks.size() > MAX_WARM_CHUNKS)
+            m_WarmChunks.pop_front();
+    }
+
+    if(res.usage == ResourceUsage::Picture && !QGlk::getMainWindow().isImageCached(res.number)) {
+        /* the chunk stays in m_DecodingChunks until the decode is done so it is only ever unloaded on the glk thread */
+        std::uint64_t key = res.key();
+        glui32 number = res.number;
+        m_DecodingChunks[key] = chunk;
+        m_DecodePool.start(new ImageDecodeTask{chunk.data(), chunk.length(), [this, key, number](QImage img) {
+            if(!img.isNull())
+                QGlk::getMainWindow().cacheImage(number, img);
+
+            std::lock_guard lock{m_Mutex};
+            m_FinishedDecodes.push_back(key);
+        }});
+    }
+
+    SPDLOG_TRACE("Prefetched {} resource {}", res.usage == ResourceUsage::Picture ? "picture" : "sound", res.number);
+}
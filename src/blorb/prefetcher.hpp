@@ -0,0 +1,101 @@
+#ifndef PREFETCHER_HPP
+#define PREFETCHER_HPP
+
+#include <cstdint>
+
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <QThreadPool>
+
+#include "glk.hpp"
+
+#include "chunk.hpp"
+
+namespace Glk {
+    namespace Blorb {
+        /// Warms the chunk map and the decode caches ahead of use.
+        ///   The order in which the game touches its images and sounds is learnt across runs (keyed by a fingerprint
+        ///   of the blorb resource index) and replayed while the glk thread is idle waiting for events.
+        class Prefetcher {
+                Q_DISABLE_COPY(Prefetcher)
+
+                static constexpr size_t LOOKAHEAD = 4;
+                static constexpr size_t MAX_HISTORY = 4096;
+                static constexpr size_t MAX_WARM_CHUNKS = 32;
+
+                struct Resource {
+                    ResourceUsage usage;
+                    glui32 number;
+
+                    [[nodiscard]] inline std::uint64_t key() const {
+                        return (std::uint64_t(usage) << 32) | number;
+                    }
+
+                    [[nodiscard]] inline bool operator==(const Resource& other) const {
+                        return usage == other.usage && number == other.number;
+                    }
+                };
+
+            public:
+                Prefetcher();
+
+                ~Prefetcher();
+
+
+                /// Loads (or releases) a sound ahead of time, as requested by glk_sound_load_hint.
+                void hint(ResourceUsage usage, glui32 number, bool load);
+
+                /// Performs one unit of prefetch work. Returns false when there is nothing left to do.
+                ///   This must be called from the glk thread.
+                bool prefetchNext();
+
+                /// Records that the game used the given resource. Safe to call from any thread: under the prefetcher's
+                ///   lock it only reads the blorb's resource index, which is in memory, and the access history file. It
+                ///   never loads a chunk.
+                void recordAccess(ResourceUsage usage, glui32 number);
+
+            private:
+                void enqueuePredictions(const Resource& res);
+
+                void loadHistory();
+
+                void releaseFinishedDecodes();
+
+                void saveHistory() const;
+
+                bool setupResourceMap();
+
+                /// Loads the chunk of a resource already marked as warmed. Called without the lock, which is only
+                ///   taken once the chunk is loaded to keep it.
+                void warm(const Resource& res);
+
+
+                mutable std::mutex m_Mutex;
+
+                giblorb_map_t* mp_Map{nullptr};
+                std::filesystem::path m_HistoryPath;
+
+                std::vector<Resource> m_History;
+                std::unordered_map<std::uint64_t, size_t> m_HistoryIndex;
+                std::vector<Resource> m_SessionOrder;
+                std::unordered_set<std::uint64_t> m_SessionSeen;
+
+                std::deque<Resource> m_Queue;
+                std::unordered_set<std::uint64_t> m_Warmed;
+                std::deque<Chunk> m_WarmChunks;
+                std::unordered_map<std::uint64_t, Chunk> m_PinnedChunks;
+
+                std::unordered_map<std::uint64_t, Chunk> m_DecodingChunks;
+                std::vector<std::uint64_t> m_FinishedDecodes;
+
+                QThreadPool m_DecodePool;
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,115 @@
+#include "resourcepack.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace {
+    constexpr std::uint64_t MAX_INT = std::uint64_t(std::numeric_limits<int>::max());
+
+    /* everything handed out points straight into the mapping, so an entry has to describe data that lies wholly
+     * inside the file before anything is trusted to it */
+    bool isValidEntry(const Glk::Blorb::Pack::Entry& entry, std::uint64_t size) {
+        if(entry.offset % Glk::Blorb::Pack::ALIGNMENT != 0 || entry.offset > size || entry.length > size - entry.offset)
+            return false;
+
+        switch(entry.kind) {
+            case Glk::Blorb::Pack::Kind::Image:
+                /* 4 bytes per ARGB32 pixel, and every size ends up as an int in QImage */
+                return entry.width != 0 && entry.height != 0 && entry.stride % 4 == 0 &&
+                       entry.stride <= MAX_INT && entry.height <= MAX_INT &&
+                       std::uint64_t(entry.stride) >= std::uint64_t(entry.width) * 4 &&
+                       std::uint64_t(entry.stride) * entry.height <= entry.length;
+
+            case Glk::Blorb::Pack::Kind::Sound:
+                return entry.length <= MAX_INT;
+        }
+
+        return false;
+    }
+}
+
+bool Glk::Blorb::ResourcePack::open(const QString& path, std::uint64_t fingerprint) {
+    if(isOpen())
+        return false;
+
+    m_File.setFileName(path);
+    if(!m_File.open(QIODevice::ReadOnly))
+        return false;
+
+    qint64 size = m_File.size();
+    if(size < qint64(sizeof(Pack::Header))) {
+        m_File.close();
+        return false;
+    }
+
+    const uchar* base = m_File.map(0, size);
+    if(!base) {
+        m_File.close();
+        return false;
+    }
+
+    const auto* header = reinterpret_cast<const Pack::Header*>(base);
+    bool valid = std::memcmp(header->magic, Pack::MAGIC, sizeof(Pack::MAGIC)) == 0 &&
+                 header->version == Pack::VERSION &&
+                 header->fingerprint == fingerprint &&
+                 qint64(sizeof(Pack::Header) + std::uint64_t(header->entryCount) * sizeof(Pack::Entry)) <= size;
+
+    /* the entries are binary searched, so they have to be in order as well */
+    const auto* entries = reinterpret_cast<const Pack::Entry*>(base + sizeof(Pack::Header));
+    for(std::uint32_t ii = 0; valid && ii < header->entryCount; ii++)
+        valid = isValidEntry(entries[ii], std::uint64_t(size)) &&
+                (ii == 0 || std::make_pair(entries[ii - 1].kind, entries[ii - 1].number) <=
+                            std::make_pair(entries[ii].kind, entries[ii].number));
+
+    if(!valid) {
+        m_File.unmap(const_cast<uchar*>(base));
+        m_File.close();
+        return false;
+    }
+
+    mp_Base = base;
+    mp_Entries = entries;
+    m_EntryCount = header->entryCount;
+
+    return true;
+}
+
+QImage Glk::Blorb::ResourcePack::image(std::uint32_t number, QSize size) const {
+    const Pack::Entry* entry = find(Pack::Kind::Image, number, size);
+    if(!entry)
+        return {};
+
+    /* the const overload leaves the data where it is; anything that writes to the image detaches it first */
+    return QImage{mp_Base + entry->offset, int(entry->width), int(entry->height), int(entry->stride),
+                  QImage::Format_ARGB32_Premultiplied};
+}
+
+QByteArray Glk::Blorb::ResourcePack::sound(std::uint32_t number) const {
+    const Pack::Entry* entry = find(Pack::Kind::Sound, number, {});
+    if(!entry)
+        return {};
+
+    return QByteArray::fromRawData(reinterpret_cast<const char*>(mp_Base + entry->offset), int(entry->length));
+}
+
+const Glk::Blorb::Pack::Entry* Glk::Blorb::ResourcePack::find(Pack::Kind kind, std::uint32_t number, QSize size) const {
+    if(!isOpen())
+        return nullptr;
+
+    auto fn_less = [](const Pack::Entry& entry, std::pair<Pack::Kind, std::uint32_t> key) {
+        return std::make_pair(entry.kind, entry.number) < key;
+    };
+
+    const Pack::Entry* end = mp_Entries + m_EntryCount;
+    for(const Pack::Entry* it = std::lower_bound(mp_Entries, end, std::make_pair(kind, number), fn_less);
+        it != end && it->kind == kind && it->number == number; ++it) {
+        if(kind == Pack::Kind::Sound)
+            return it;
+
+        if(size.isEmpty() ? it->original != 0 : (int(it->width) == size.width() && int(it->height) == size.height()))
+            return it;
+    }
+
+    return nullptr;
+}
@@ -0,0 +1,110 @@
+#ifndef RESOURCEPACK_HPP
+#define RESOURCEPACK_HPP
+
+#include <cstdint>
+
+#include <QByteArray>
+#include <QFile>
+#include <QImage>
+#include <QSize>
+
+namespace Glk {
+    namespace Blorb {
+        /// On-disk layout of a precompiled resource pack (see tools/pack).
+        ///   A pack sits next to the blorb file it was built from (as "<blorb>.qglkpack") and holds the pictures
+        ///   already decoded to ARGB32 premultiplied, optionally in some scaled variants, and the sounds already
+        ///   decoded to PCM. Everything is in host byte order and the data is aligned so it can be used straight
+        ///   out of a memory mapping.
+        namespace Pack {
+            constexpr char MAGIC[4] = {'Q', 'G', 'P', 'K'};
+            constexpr std::uint32_t VERSION = 1;
+            constexpr std::uint32_t ALIGNMENT = 64;
+            constexpr char SUFFIX[] = ".qglkpack";
+
+            enum class Kind : std::uint32_t {
+                Image = 1,
+                Sound = 2
+            };
+
+            struct Header {
+                char magic[4];
+                std::uint32_t version;
+                std::uint64_t fingerprint; /* IndexFingerprint of the source blorb */
+                std::uint32_t entryCount;
+                std::uint32_t reserved;
+            };
+
+            /* the entries follow the header, sorted by (kind, number, width, height) */
+            struct Entry {
+                Kind kind;
+                std::uint32_t number;
+                std::uint32_t width;  /* image: width in pixels, sound: sample rate */
+                std::uint32_t height; /* image: height in pixels, sound: channel count */
+                std::uint32_t stride; /* image: bytes per line, sound: bytes per frame */
+                std::uint32_t original; /* non-zero for the image at its native size */
+                std::uint64_t offset;
+                std::uint64_t length; /* sound: a complete WAV file */
+            };
+
+            static_assert(sizeof(Header) == 24);
+            static_assert(sizeof(Entry) == 40);
+        }
+
+        /// FNV-1a over the blorb resource index, used to tell whether caches built for a game still apply.
+        ///   Resources must be added sorted by usage (pictures, sounds, executables) and then by number.
+        class IndexFingerprint {
+            public:
+                inline void add(std::uint32_t usage, std::uint32_t number, std::uint32_t chunkType, std::uint32_t length) {
+                    mix(usage);
+                    mix(number);
+                    mix(chunkType);
+                    mix(length);
+                }
+
+                [[nodiscard]] inline std::uint64_t value() const {
+                    return m_Hash;
+                }
+
+            private:
+                inline void mix(std::uint32_t val) {
+                    for(int ii = 0; ii < 4; ii++) {
+                        m_Hash ^= (val >> (8 * ii)) & 0xff;
+                        m_Hash *= 0x100000001b3ull;
+                    }
+                }
+
+                std::uint64_t m_Hash{0xcbf29ce484222325ull};
+        };
+
+        /// Read-only view of a resource pack, backed by a memory mapping of the file.
+        ///   Images and sounds handed out point into the mapping, which stays valid for the lifetime of the object.
+        class ResourcePack {
+                Q_DISABLE_COPY(ResourcePack)
+            public:
+                ResourcePack() = default;
+
+                /// Maps the pack at the given path. Fails if the pack is malformed or was built from another blorb.
+                bool open(const QString& path, std::uint64_t fingerprint);
+
+                [[nodiscard]] inline bool isOpen() const {
+                    return mp_Entries != nullptr;
+                }
+
+                /// The decoded picture, at its native size when size is empty or at a prescaled size if present.
+                [[nodiscard]] QImage image(std::uint32_t number, QSize size = {}) const;
+
+                /// The decoded sound as a WAV file.
+                [[nodiscard]] QByteArray sound(std::uint32_t number) const;
+
+            private:
+                [[nodiscard]] const Pack::Entry* find(Pack::Kind kind, std::uint32_t number, QSize size) const;
+
+                QFile m_File;
+                const uchar* mp_Base{nullptr};
+                const Pack::Entry* mp_Entries{nullptr};
+                std::uint32_t m_EntryCount{0};
+        };
+    }
+}
+
+#endif
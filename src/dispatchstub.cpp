@@ -0,0 +1,191 @@
+#include "dispatchstub.hpp"
+
+#include <array>
+
+namespace {
+    using namespace Glk::DispatchStub;
+
+    using Window = In<winid_t>;
+    using Stream = In<strid_t>;
+    using FileRef = In<frefid_t>;
+    using Channel = In<schanid_t>;
+    using Uint = In<glui32>;
+    using Sint = In<glsi32>;
+
+    constexpr std::size_t FUNCTION_COUNT = 0x170; /* one past the highest function id */
+
+    /* The arguments of every function as gidispatch_prototype() gives them. set_interrupt_handler (0x0002) cannot
+     * be called through dispatch and has no stub. */
+    constexpr std::array<Stub, FUNCTION_COUNT> makeStubs() {
+        std::array<Stub, FUNCTION_COUNT> stubs{};
+
+        stubs[0x0001] = &call<glk_exit>;
+        stubs[0x0003] = &call<glk_tick>;
+        stubs[0x0004] = &call<glk_gestalt, Uint, Uint>;
+        stubs[0x0005] = &call<glk_gestalt_ext, Uint, Uint, Array<glui32>>;
+
+        stubs[0x0020] = &call<glk_window_iterate, Window, OptionalRef<glui32>>;
+        stubs[0x0021] = &call<glk_window_get_rock, Window>;
+        stubs[0x0022] = &call<glk_window_get_root>;
+        stubs[0x0023] = &call<glk_window_open, Window, Uint, Uint, Uint, Uint>;
+        stubs[0x0024] = &call<glk_window_close, Window, StructOut<stream_result_t>>;
+        stubs[0x0025] = &call<glk_window_get_size, Window, OptionalRef<glui32>, OptionalRef<glui32>>;
+        stubs[0x0026] = &call<glk_window_set_arrangement, Window, Uint, Uint, Window>;
+        stubs[0x0027] = &call<glk_window_get_arrangement, Window, OptionalRef<glui32>, OptionalRef<glui32>,
+                              OptionalRef<winid_t>>;
+        stubs[0x0028] = &call<glk_window_get_type, Window>;
+        stubs[0x0029] = &call<glk_window_get_parent, Window>;
+        stubs[0x002A] = &call<glk_window_clear, Window>;
+        stubs[0x002B] = &call<glk_window_move_cursor, Window, Uint, Uint>;
+        stubs[0x002C] = &call<glk_window_get_stream, Window>;
+        stubs[0x002D] = &call<glk_window_set_echo_stream, Window, Stream>;
+        stubs[0x002E] = &call<glk_window_get_echo_stream, Window>;
+        stubs[0x002F] = &call<glk_set_window, Window>;
+        stubs[0x0030] = &call<glk_window_get_sibling, Window>;
+
+        stubs[0x0040] = &call<glk_stream_iterate, Stream, OptionalRef<glui32>>;
+        stubs[0x0041] = &call<glk_stream_get_rock, Stream>;
+        stubs[0x0042] = &call<glk_stream_open_file, FileRef, Uint, Uint>;
+        stubs[0x0043] = &call<glk_stream_open_memory, Array<char>, Uint, Uint>;
+        stubs[0x0044] = &call<glk_stream_close, Stream, StructOut<stream_result_t>>;
+        stubs[0x0045] = &call<glk_stream_set_position, Stream, Sint, Uint>;
+        stubs[0x0046] = &call<glk_stream_get_position, Stream>;
+        stubs[0x0047] = &call<glk_stream_set_current, Stream>;
+        stubs[0x0048] = &call<glk_stream_get_current>;
+
+        stubs[0x0060] = &call<glk_fileref_create_temp, Uint, Uint>;
+        stubs[0x0061] = &call<glk_fileref_create_by_name, Uint, In<char*>, Uint>;
+        stubs[0x0062] = &call<glk_fileref_create_by_prompt, Uint, Uint, Uint>;
+        stubs[0x0063] = &call<glk_fileref_destroy, FileRef>;
+        stubs[0x0064] = &call<glk_fileref_iterate, FileRef, OptionalRef<glui32>>;
+        stubs[0x0065] = &call<glk_fileref_get_rock, FileRef>;
+        stubs[0x0066] = &call<glk_fileref_delete_file, FileRef>;
+        stubs[0x0067] = &call<glk_fileref_does_file_exist, FileRef>;
+        stubs[0x0068] = &call<glk_fileref_create_from_fileref, Uint, FileRef, Uint>;
+
+        stubs[0x0080] = &call<glk_put_char, In<unsigned char>>;
+        stubs[0x0081] = &call<glk_put_char_stream, Stream, In<unsigned char>>;
+        stubs[0x0082] = &call<glk_put_string, In<char*>>;
+        stubs[0x0083] = &call<glk_put_string_stream, Stream, In<char*>>;
+        stubs[0x0084] = &call<glk_put_buffer, Array<char>>;
+        stubs[0x0085] = &call<glk_put_buffer_stream, Stream, Array<char>>;
+        stubs[0x0086] = &call<glk_set_style, Uint>;
+        stubs[0x0087] = &call<glk_set_style_stream, Stream, Uint>;
+        stubs[0x0090] = &call<glk_get_char_stream, Stream>;
+        stubs[0x0091] = &call<glk_get_line_stream, Stream, Array<char>>;
+        stubs[0x0092] = &call<glk_get_buffer_stream, Stream, Array<char>>;
+        stubs[0x00A0] = &call<glk_char_to_lower, In<unsigned char>>;
+        stubs[0x00A1] = &call<glk_char_to_upper, In<unsigned char>>;
+
+        stubs[0x00B0] = &call<glk_stylehint_set, Uint, Uint, Uint, Sint>;
+        stubs[0x00B1] = &call<glk_stylehint_clear, Uint, Uint, Uint>;
+        stubs[0x00B2] = &call<glk_style_distinguish, Window, Uint, Uint>;
+        stubs[0x00B3] = &call<glk_style_measure, Window, Uint, Uint, OptionalRef<glui32>>;
+
+        stubs[0x00C0] = &call<glk_select, StructOut<event_t>>;
+        stubs[0x00C1] = &call<glk_select_poll, StructOut<event_t>>;
+        stubs[0x00D0] = &call<glk_request_line_event, Window, Array<char>, Uint>;
+        stubs[0x00D1] = &call<glk_cancel_line_event, Window, StructOut<event_t>>;
+        stubs[0x00D2] = &call<glk_request_char_event, Window>;
+        stubs[0x00D3] = &call<glk_cancel_char_event, Window>;
+        stubs[0x00D4] = &call<glk_request_mouse_event, Window>;
+        stubs[0x00D5] = &call<glk_cancel_mouse_event, Window>;
+        stubs[0x00D6] = &call<glk_request_timer_events, Uint>;
+
+#ifdef GLK_MODULE_IMAGE
+        stubs[0x00E0] = &call<glk_image_get_info, Uint, OptionalRef<glui32>, OptionalRef<glui32>>;
+        stubs[0x00E1] = &call<glk_image_draw, Window, Uint, Sint, Sint>;
+        stubs[0x00E2] = &call<glk_image_draw_scaled, Window, Uint, Sint, Sint, Uint, Uint>;
+        stubs[0x00E8] = &call<glk_window_flow_break, Window>;
+        stubs[0x00E9] = &call<glk_window_erase_rect, Window, Sint, Sint, Uint, Uint>;
+        stubs[0x00EA] = &call<glk_window_fill_rect, Window, Uint, Sint, Sint, Uint, Uint>;
+        stubs[0x00EB] = &call<glk_window_set_background_color, Window, Uint>;
+#endif /* GLK_MODULE_IMAGE */
+
+#ifdef GLK_MODULE_SOUND
+        stubs[0x00F0] = &call<glk_schannel_iterate, Channel, OptionalRef<glui32>>;
+        stubs[0x00F1] = &call<glk_schannel_get_rock, Channel>;
+        stubs[0x00F2] = &call<glk_schannel_create, Uint>;
+        stubs[0x00F3] = &call<glk_schannel_destroy, Channel>;
+        stubs[0x00F8] = &call<glk_schannel_play, Channel, Uint>;
+        stubs[0x00F9] = &call<glk_schannel_play_ext, Channel, Uint, Uint, Uint>;
+        stubs[0x00FA] = &call<glk_schannel_stop, Channel>;
+        stubs[0x00FB] = &call<glk_schannel_set_volume, Channel, Uint>;
+        stubs[0x00FC] = &call<glk_sound_load_hint, Uint, Uint>;
+
+#ifdef GLK_MODULE_SOUND2
+        stubs[0x00F4] = &call<glk_schannel_create_ext, Uint, Uint>;
+        stubs[0x00F7] = &call<glk_schannel_play_multi, Array<schanid_t>, Array<glui32>, Uint>;
+        stubs[0x00FD] = &call<glk_schannel_set_volume_ext, Channel, Uint, Uint, Uint>;
+        stubs[0x00FE] = &call<glk_schannel_pause, Channel>;
+        stubs[0x00FF] = &call<glk_schannel_unpause, Channel>;
+#endif /* GLK_MODULE_SOUND2 */
+#endif /* GLK_MODULE_SOUND */
+
+#ifdef GLK_MODULE_HYPERLINKS
+        stubs[0x0100] = &call<glk_set_hyperlink, Uint>;
+        stubs[0x0101] = &call<glk_set_hyperlink_stream, Stream, Uint>;
+        stubs[0x0102] = &call<glk_request_hyperlink_event, Window>;
+        stubs[0x0103] = &call<glk_cancel_hyperlink_event, Window>;
+#endif /* GLK_MODULE_HYPERLINKS */
+
+#ifdef GLK_MODULE_UNICODE
+        stubs[0x0120] = &call<glk_buffer_to_lower_case_uni, Array<glui32>, Uint>;
+        stubs[0x0121] = &call<glk_buffer_to_upper_case_uni, Array<glui32>, Uint>;
+        stubs[0x0122] = &call<glk_buffer_to_title_case_uni, Array<glui32>, Uint, Uint>;
+        stubs[0x0128] = &call<glk_put_char_uni, Uint>;
+        stubs[0x0129] = &call<glk_put_string_uni, In<glui32*>>;
+        stubs[0x012A] = &call<glk_put_buffer_uni, Array<glui32>>;
+        stubs[0x012B] = &call<glk_put_char_stream_uni, Stream, Uint>;
+        stubs[0x012C] = &call<glk_put_string_stream_uni, Stream, In<glui32*>>;
+        stubs[0x012D] = &call<glk_put_buffer_stream_uni, Stream, Array<glui32>>;
+        stubs[0x0130] = &call<glk_get_char_stream_uni, Stream>;
+        stubs[0x0131] = &call<glk_get_buffer_stream_uni, Stream, Array<glui32>>;
+        stubs[0x0132] = &call<glk_get_line_stream_uni, Stream, Array<glui32>>;
+        stubs[0x0138] = &call<glk_stream_open_file_uni, FileRef, Uint, Uint>;
+        stubs[0x0139] = &call<glk_stream_open_memory_uni, Array<glui32>, Uint, Uint>;
+        stubs[0x0140] = &call<glk_request_char_event_uni, Window>;
+        stubs[0x0141] = &call<glk_request_line_event_uni, Window, Array<glui32>, Uint>;
+#endif /* GLK_MODULE_UNICODE */
+
+#ifdef GLK_MODULE_UNICODE_NORM
+        stubs[0x0123] = &call<glk_buffer_canon_decompose_uni, Array<glui32>, Uint>;
+        stubs[0x0124] = &call<glk_buffer_canon_normalize_uni, Array<glui32>, Uint>;
+#endif /* GLK_MODULE_UNICODE_NORM */
+
+#ifdef GLK_MODULE_LINE_ECHO
+        stubs[0x0150] = &call<glk_set_echo_line_event, Window, Uint>;
+#endif /* GLK_MODULE_LINE_ECHO */
+
+#ifdef GLK_MODULE_LINE_TERMINATORS
+        stubs[0x0151] = &call<glk_set_terminators_line_event, Window, Array<glui32>>;
+#endif /* GLK_MODULE_LINE_TERMINATORS */
+
+#ifdef GLK_MODULE_DATETIME
+        stubs[0x0160] = &call<glk_current_time, StructOut<glktimeval_t>>;
+        stubs[0x0161] = &call<glk_current_simple_time, Uint>;
+        stubs[0x0168] = &call<glk_time_to_date_utc, StructIn<glktimeval_t>, StructOut<glkdate_t>>;
+        stubs[0x0169] = &call<glk_time_to_date_local, StructIn<glktimeval_t>, StructOut<glkdate_t>>;
+        stubs[0x016A] = &call<glk_simple_time_to_date_utc, Sint, Uint, StructOut<glkdate_t>>;
+        stubs[0x016B] = &call<glk_simple_time_to_date_local, Sint, Uint, StructOut<glkdate_t>>;
+        stubs[0x016C] = &call<glk_date_to_time_utc, StructIn<glkdate_t>, StructOut<glktimeval_t>>;
+        stubs[0x016D] = &call<glk_date_to_time_local, StructIn<glkdate_t>, StructOut<glktimeval_t>>;
+        stubs[0x016E] = &call<glk_date_to_simple_time_utc, StructIn<glkdate_t>, Uint>;
+        stubs[0x016F] = &call<glk_date_to_simple_time_local, StructIn<glkdate_t>, Uint>;
+#endif /* GLK_MODULE_DATETIME */
+
+#ifdef GLK_MODULE_RESOURCE_STREAM
+        stubs[0x0049] = &call<glk_stream_open_resource, Uint, Uint>;
+        stubs[0x013A] = &call<glk_stream_open_resource_uni, Uint, Uint>;
+#endif /* GLK_MODULE_RESOURCE_STREAM */
+
+        return stubs;
+    }
+
+    constexpr std::array<Stub, FUNCTION_COUNT> STUBS = makeStubs();
+}
+
+void gidispatch_call(glui32 funcnum, glui32 /* numargs */, gluniversal_t* arglist) {
+    if(funcnum < FUNCTION_COUNT && STUBS[funcnum])
+        STUBS[funcnum](arglist);
+}
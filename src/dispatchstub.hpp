@@ -0,0 +1,210 @@
+#ifndef DISPATCHSTUB_HPP
+#define DISPATCHSTUB_HPP
+
+#include <tuple>
+#include <type_traits>
+
+extern "C" {
+#include "glk.h"
+#include "gi_dispa.h"
+}
+
+namespace Glk::DispatchStub {
+    /// Walks an argument list in the order gidispatch_prototype() lays it out.
+    class Arguments {
+        public:
+            explicit Arguments(gluniversal_t* args) : mp_Args{args}, m_Index{0} {}
+
+
+            inline gluniversal_t& take() {
+                return mp_Args[m_Index++];
+            }
+
+            /* every reference, array and struct starts with a flag telling whether it is there */
+            inline bool takeFlag() {
+                return take().ptrflag != 0;
+            }
+
+        private:
+            gluniversal_t* mp_Args;
+            int m_Index;
+    };
+
+    /* the member of gluniversal_t a native type travels in */
+    template<typename T>
+    inline T read(const gluniversal_t& arg) {
+        if constexpr(std::is_same_v<T, glui32>)
+            return arg.uint;
+        else if constexpr(std::is_same_v<T, glsi32>)
+            return arg.sint;
+        else if constexpr(std::is_same_v<T, unsigned char>)
+            return arg.uch;
+        else if constexpr(std::is_same_v<T, char*>)
+            return arg.charstr;
+        else if constexpr(std::is_same_v<T, glui32*>)
+            return arg.unicharstr;
+        else
+            return static_cast<T>(arg.opaqueref);
+    }
+
+    template<typename T>
+    inline void write(gluniversal_t& arg, T value) {
+        if constexpr(std::is_same_v<T, glui32>)
+            arg.uint = value;
+        else if constexpr(std::is_same_v<T, glsi32>)
+            arg.sint = value;
+        else if constexpr(std::is_same_v<T, unsigned char>)
+            arg.uch = value;
+        else
+            arg.opaqueref = value;
+    }
+
+    template<typename T>
+    inline T* address(gluniversal_t& arg) {
+        if constexpr(std::is_same_v<T, glui32>)
+            return &arg.uint;
+        else
+            return reinterpret_cast<T*>(&arg.opaqueref);
+    }
+
+    /// The fields of the structs passed by reference, in the order they are laid out in the argument list.
+    template<typename S>
+    struct StructLayout;
+
+    template<>
+    struct StructLayout<event_t> {
+        static constexpr auto FIELDS = std::make_tuple(&event_t::type, &event_t::win, &event_t::val1,
+                                                       &event_t::val2);
+    };
+
+    template<>
+    struct StructLayout<stream_result_t> {
+        static constexpr auto FIELDS = std::make_tuple(&stream_result_t::readcount, &stream_result_t::writecount);
+    };
+
+    template<>
+    struct StructLayout<glktimeval_t> {
+        static constexpr auto FIELDS = std::make_tuple(&glktimeval_t::high_sec, &glktimeval_t::low_sec,
+                                                       &glktimeval_t::microsec);
+    };
+
+    template<>
+    struct StructLayout<glkdate_t> {
+        static constexpr auto FIELDS = std::make_tuple(&glkdate_t::year, &glkdate_t::month, &glkdate_t::day,
+                                                       &glkdate_t::weekday, &glkdate_t::hour, &glkdate_t::minute,
+                                                       &glkdate_t::second, &glkdate_t::microsec);
+    };
+
+    /* Each policy below turns one argument of a prototype into the native parameters it stands for. load() reads
+     * the argument and returns the parameters as a tuple, and store() writes back what the call produced. */
+
+    /// A value passed in one argument: "Iu", "Is", "Cu", "S", "U" or "Qa" to "Qd".
+    template<typename T>
+    struct In {
+        std::tuple<T> load(Arguments& args) {
+            return {read<T>(args.take())};
+        }
+
+        void store() {}
+    };
+
+    /// A value the call writes through a pointer that may be null: "<Iu" or "<Qa".
+    template<typename T>
+    struct OptionalRef {
+        std::tuple<T*> load(Arguments& args) {
+            return {args.takeFlag() ? address<T>(args.take()) : nullptr};
+        }
+
+        void store() {}
+    };
+
+    /// An array and its length, both left out when the array is null: "&#Iu", "&+#!Cn", ">+#Cn", "<+#Iu"...
+    template<typename T>
+    struct Array {
+        std::tuple<T*, glui32> load(Arguments& args) {
+            if(!args.takeFlag())
+                return {nullptr, 0};
+
+            auto array = static_cast<T*>(args.take().array);
+            return {array, args.take().uint};
+        }
+
+        void store() {}
+    };
+
+    /// A struct passed to the call: ">+[3IsIuIs]" or ">+[8IsIsIsIsIsIsIsIs]".
+    template<typename S>
+    struct StructIn {
+        S value;
+        S* pointer{nullptr};
+
+        std::tuple<S*> load(Arguments& args) {
+            if(args.takeFlag()) {
+                pointer = &value;
+                std::apply([&](auto... members) {
+                    ((value.*members = read<std::remove_reference_t<decltype(value.*members)>>(args.take())), ...);
+                }, StructLayout<S>::FIELDS);
+            }
+
+            return {pointer};
+        }
+
+        void store() {}
+    };
+
+    /// A struct the call fills in, copied back field by field: "<[2IuIu]", "<+[4IuQaIuIu]"...
+    template<typename S>
+    struct StructOut {
+        S value;
+        S* pointer{nullptr};
+        gluniversal_t* fields{nullptr};
+
+        std::tuple<S*> load(Arguments& args) {
+            if(args.takeFlag()) {
+                pointer = &value;
+                fields = &args.take();
+                /* the other fields follow the first one */
+                for(std::size_t ii = 1; ii < std::tuple_size_v<decltype(StructLayout<S>::FIELDS)>; ii++)
+                    args.take();
+            }
+
+            return {pointer};
+        }
+
+        void store() {
+            if(!pointer)
+                return;
+
+            gluniversal_t* field = fields;
+            std::apply([&](auto... members) { (write(*field++, value.*members), ...); }, StructLayout<S>::FIELDS);
+        }
+    };
+
+    /// Calls Function with the arguments of a dispatch call laid out as the policies describe, then writes back
+    ///   the structs and the result. The result comes last, after a flag of its own.
+    template<auto Function, typename... Policies>
+    void call(gluniversal_t* arglist) {
+        Arguments args{arglist};
+        std::tuple<Policies...> policies;
+
+        /* braced initialization loads the arguments in order */
+        auto loaded = std::apply([&](Policies&... policy) {
+            return std::tuple<decltype(policy.load(args))...>{policy.load(args)...};
+        }, policies);
+        auto natives = std::apply([](auto&... parts) { return std::tuple_cat(parts...); }, loaded);
+
+        if constexpr(std::is_void_v<decltype(std::apply(Function, natives))>) {
+            std::apply(Function, natives);
+        } else {
+            auto result = std::apply(Function, natives);
+            args.take();
+            write(args.take(), result);
+        }
+
+        std::apply([](Policies&... policy) { (policy.store(), ...); }, policies);
+    }
+
+    using Stub = void (*)(gluniversal_t*);
+}
+
+#endif //DISPATCHSTUB_HPP
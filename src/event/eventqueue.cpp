@@ -13,7 +13,14 @@ Glk::EventQueue::EventQueue(QObject* parent)
     : QObject{parent},
       m_Queue{},
       m_Semaphore{0},
+      m_ArrangeTimer{},
+      m_LastArrange{},
+      m_ArrangePending{false},
+      m_ArrangeWindow{nullptr},
       m_Terminate{false} {
+    m_ArrangeTimer.setSingleShot(true);
+    m_ArrangeTimer.setInterval(ARRANGE_SETTLE_DELAY);
+    connect(&m_ArrangeTimer, &QTimer::timeout, this, &EventQueue::flushArrangeEvent);
 }
 
 void Glk::EventQueue::requestImmediateSynchronization() {
@@ -27,15 +34,58 @@ void Glk::EventQueue::requestImmediateSynchronization() {
     }
 }
 
+void Glk::EventQueue::pushArrangeEvent(winid_t win) {
+    assert(onEventThread());
+
+    {
+        QMutexLocker ml(&m_AccessMutex);
+
+        if(!m_ArrangePending) {
+            m_ArrangePending = true;
+            m_ArrangeWindow = win;
+        } else if(m_ArrangeWindow != win) {
+            m_ArrangeWindow = nullptr;
+        }
+    }
+
+    if(!m_LastArrange.isValid() || m_LastArrange.elapsed() >= ARRANGE_INTERVAL)
+        flushArrangeEvent();
+
+    m_ArrangeTimer.start();
+}
+
+void Glk::EventQueue::flushArrangeEvent() {
+    event_t ev;
+
+    {
+        QMutexLocker ml(&m_AccessMutex);
+
+        if(!m_ArrangePending)
+            return;
+
+        ev = event_t{evtype_Arrange, m_ArrangeWindow, 0, 0};
+        m_ArrangePending = false;
+    }
+
+    m_LastArrange.restart();
+    push(ev);
+}
+
 event_t Glk::EventQueue::pop() {
     assert(onGlkThread());
 
     event_t ev;
 
     do {
-        emit canSynchronize();
+        synchronize();
 
-        m_Semaphore.acquire(1);
+        /* while there is nothing to deliver we use the time to warm the resource caches */
+        while(!m_Semaphore.tryAcquire(1)) {
+            if(!QGlk::getMainWindow().prefetcher().prefetchNext()) {
+                m_Semaphore.acquire(1);
+                break;
+            }
+        }
 
         if(m_Terminate) {
             QGlk::getMainWindow().statusChannel().push(QGlk::GlkStatus::eINTERRUPTED);
@@ -55,11 +105,18 @@ event_t Glk::EventQueue::pop() {
         }
     } while(ev.type == evtype_TaskEvent || ev.type == evtype_None);
 
-    emit canSynchronize();
+    synchronize();
 
     return ev;
 }
 
+void Glk::EventQueue::synchronize() {
+    /* windows draw what they recorded while the glk thread still runs, the event thread only shows it */
+    QGlk::getMainWindow().flushWindows();
+
+    emit canSynchronize();
+}
+
 event_t Glk::EventQueue::popLineEvent(Glk::Window* win) {
     assert(onEventThread());
     assert(win);
@@ -82,7 +139,7 @@ event_t Glk::EventQueue::popLineEvent(Glk::Window* win) {
 event_t Glk::EventQueue::poll() {
     assert(onGlkThread());
 
-    emit canSynchronize();
+    synchronize();
 
     if(m_Terminate) {
         QGlk::getMainWindow().statusChannel().push(QGlk::GlkStatus::eINTERRUPTED);
@@ -114,7 +171,8 @@ event_t Glk::EventQueue::poll() {
 
             case evtype_Timer:
             case evtype_Arrange:
-            case evtype_SoundNotify: {
+            case evtype_SoundNotify:
+            case evtype_VolumeNotify: {
                 ev = m_Queue.takeAt(ii);
                 m_Semaphore.acquire(1);
                 return ev;
@@ -133,6 +191,10 @@ void Glk::EventQueue::interrupt() {
 void Glk::EventQueue::cleanWindowEvents(winid_t win) {
     QMutexLocker ml(&m_AccessMutex);
 
+    /* the other windows still need to hear about the change */
+    if(m_ArrangePending && m_ArrangeWindow == win)
+        m_ArrangeWindow = nullptr;
+
     for(int ii = 0; ii < m_Queue.size(); ii++) {
         if(m_Queue[ii].win == win) {
             m_Queue.removeAt(ii--);
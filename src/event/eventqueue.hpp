@@ -1,10 +1,12 @@
 #ifndef EVENTQUEUE_HPP
 #define EVENTQUEUE_HPP
 
+#include <QElapsedTimer>
 #include <QObject>
 #include <QQueue>
 #include <QMutex>
 #include <QSemaphore>
+#include <QTimer>
 
 #include <fmt/format.h>
 
@@ -18,6 +20,10 @@ namespace Glk {
 
     class EventQueue : public QObject {
         Q_OBJECT
+
+        static constexpr int ARRANGE_INTERVAL = 100; /* ms between Arrange events while sizes keep changing */
+        static constexpr int ARRANGE_SETTLE_DELAY = 150; /* ms without changes before the last one is sent */
+
     public:
         static std::string_view typeName(glui32 t);
 
@@ -42,6 +48,11 @@ namespace Glk {
         }
 
         void requestImmediateSynchronization();
+
+        /// Called on the event thread when the glk size of a window changed. Requests are coalesced into one
+        ///   Arrange event, for the window or for all of them when several changed. Events are sent at most once
+        ///   per ARRANGE_INTERVAL while sizes keep changing, and once more after they settle.
+        void pushArrangeEvent(winid_t win);
         
     public slots:
         void cleanWindowEvents(winid_t win);
@@ -51,8 +62,15 @@ namespace Glk {
 
     signals:
         void canSynchronize();
+
+    private slots:
+        void flushArrangeEvent();
         
     private:
+        /// Lets the windows flush their output on the glk thread, then blocks until the event thread has
+        ///   synchronized them.
+        void synchronize();
+
         QQueue<event_t> m_Queue;
         QQueue<TaskEvent*> m_TaskEventQueue;
         QMutex m_AccessMutex;
@@ -61,6 +79,11 @@ namespace Glk {
         // calling pop waits until a new event is received
         // (i.e. release on event push, acquire on event pop)
         QSemaphore m_Semaphore;
+
+        QTimer m_ArrangeTimer;
+        QElapsedTimer m_LastArrange;
+        bool m_ArrangePending;
+        winid_t m_ArrangeWindow; /* null when more than one window changed */
         
         bool m_Terminate;
     };
@@ -14,7 +14,7 @@ Glk::FileReference::FileReference(const std::filesystem::path& path_, glui32 usa
     Q_ASSERT(!std::filesystem::is_directory(m_Path));
 
     QGlk::getMainWindow().dispatch().registerObject(this);
-    QGlk::getMainWindow().fileReferenceList().push_back(this);
+    QGlk::getMainWindow().fileReferenceTable().insert(this);
 }
 
 Glk::FileReference::FileReference(const Glk::FileReference& fref_, glui32 usage_, glui32 rock_)
@@ -22,17 +22,14 @@ Glk::FileReference::FileReference(const Glk::FileReference& fref_, glui32 usage_
           m_Path(fref_.m_Path),
           m_Usage(usage_) {
     QGlk::getMainWindow().dispatch().registerObject(this);
-    QGlk::getMainWindow().fileReferenceList().push_back(this);
+    QGlk::getMainWindow().fileReferenceTable().insert(this);
 }
 
 Glk::FileReference::~FileReference() {
-    auto& frfList = QGlk::getMainWindow().fileReferenceList();
-    if(std::count(frfList.begin(), frfList.end(), this) == 0) {
-        spdlog::warn("File reference {} not found in file reference list while removing", *this);
-    } else {
-        frfList.remove(this);
-        SPDLOG_TRACE("File reference {} removed from file reference list", *this);
-    }
+    if(!QGlk::getMainWindow().fileReferenceTable().remove(this))
+        spdlog::warn("File reference {} not found in file reference table while removing", *this);
+    else
+        SPDLOG_TRACE("File reference {} removed from file reference table", *this);
 
     QGlk::getMainWindow().dispatch().unregisterObject(this);
 }
@@ -50,6 +50,9 @@ inline frefid_t TO_FREFID(Glk::FileReference* fref) {
     return reinterpret_cast<frefid_t>(fref);
 }
 inline Glk::FileReference* FROM_FREFID(frefid_t fref) {
+    if(fref && Glk::validatingHandles())
+        Glk::validateHandle(fref, Glk::Object::FileReference);
+
     return reinterpret_cast<Glk::FileReference*>(fref);
 }
 
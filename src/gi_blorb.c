@@ -10,6 +10,11 @@
 #include "glk.h"
 #include "gi_blorb.h"
 
+/* qglk: defined in blorb/chunk.cpp. Chunks are loaded from several threads, and loading one reads the shared
+    blorb stream. */
+extern void qglk_blorb_lock(void);
+extern void qglk_blorb_unlock(void);
+
 #ifndef NULL
 #define NULL 0
 #endif
@@ -567,9 +572,17 @@ giblorb_err_t giblorb_load_image_info(giblorb_map_t *map,
     giblorb_auxpict_t *auxpict = &(map->auxpict[chu->auxdatnum]);
     if (!auxpict->loaded) {
         giblorb_result_t res;
-        giblorb_err_t err = giblorb_load_chunk_by_number(map, giblorb_method_Memory, &res, chunknum);
-        if (err)
+        giblorb_err_t err;
+        /* qglk: the chunk may be loaded already and in use on another thread, in which case it is left loaded */
+        int wasloaded;
+
+        qglk_blorb_lock();
+        wasloaded = (chu->ptr != NULL);
+        err = giblorb_load_chunk_by_number(map, giblorb_method_Memory, &res, chunknum);
+        if (err) {
+            qglk_blorb_unlock();
             return err;
+        }
 
         if (chu->type == giblorb_ID_JPEG)
             err = giblorb_image_get_size_jpeg(res.data.ptr, res.length, auxpict);
@@ -578,7 +591,9 @@ giblorb_err_t giblorb_load_image_info(giblorb_map_t *map,
         else
             err = giblorb_err_Format;
 
-        giblorb_unload_chunk(map, chunknum);
+        if (!wasloaded)
+            giblorb_unload_chunk(map, chunknum);
+        qglk_blorb_unlock();
 
         if (err)
             return err;
@@ -355,27 +355,39 @@ gidispatch_function_t *gidispatch_get_function(glui32 index)
     return &(function_table[index]);
 }
 
+/* function_table is not sorted by id (the resource stream functions come
+    last), so rather than searching it, functions are looked up by id in
+    this index. It is filled in on first use. Ids beyond its end, which
+    only extensions use, fall back to a linear search. */
+#define FUNCTION_INDEX_SIZE (0x200)
+
+static gidispatch_function_t *function_index[FUNCTION_INDEX_SIZE];
+static int function_index_built = 0;
+
+static void build_function_index()
+{
+    glui32 ix;
+
+    for (ix = 0; ix < NUMFUNCTIONS; ix++) {
+        if (function_table[ix].id < FUNCTION_INDEX_SIZE)
+            function_index[function_table[ix].id] = &(function_table[ix]);
+    }
+    function_index_built = 1;
+}
+
 gidispatch_function_t *gidispatch_get_function_by_id(glui32 id)
 {
-    int top, bot, val;
-    gidispatch_function_t *func;
-    
-    bot = 0;
-    top = NUMFUNCTIONS;
+    glui32 ix;
     
-    while (1) {
-        val = (top+bot) / 2;
-        func = &(function_table[val]);
-        if (func->id == id)
-            return func;
-        if (bot >= top-1)
-            break;
-        if (func->id < id) {
-            bot = val+1;
-        }
-        else {
-            top = val;
-        }
+    if (id < FUNCTION_INDEX_SIZE) {
+        if (!function_index_built)
+            build_function_index();
+        return function_index[id];
+    }
+
+    for (ix = 0; ix < NUMFUNCTIONS; ix++) {
+        if (function_table[ix].id == id)
+            return &(function_table[ix]);
     }
     
     return NULL;
@@ -671,837 +683,8 @@ char *gidispatch_prototype(glui32 funcnum)
     }
 }
 
-void gidispatch_call(glui32 funcnum, glui32 numargs, gluniversal_t *arglist)
-{
-    switch (funcnum) {
-        case 0x0001: /* exit */
-            glk_exit();
-            break;
-        case 0x0002: /* set_interrupt_handler */
-            /* cannot be invoked through dispatch layer */
-            break;
-        case 0x0003: /* tick */
-            glk_tick();
-            break;
-        case 0x0004: /* gestalt */
-            arglist[3].uint = glk_gestalt(arglist[0].uint, arglist[1].uint);
-            break;
-        case 0x0005: /* gestalt_ext */
-            if (arglist[2].ptrflag) {
-                arglist[6].uint = glk_gestalt_ext(arglist[0].uint, arglist[1].uint,
-                    arglist[3].array, arglist[4].uint);
-            }
-            else {
-                arglist[4].uint = glk_gestalt_ext(arglist[0].uint, arglist[1].uint,
-                    NULL, 0);
-            }
-            break;
-        case 0x0020: /* window_iterate */
-            if (arglist[1].ptrflag) 
-                arglist[4].opaqueref = glk_window_iterate(arglist[0].opaqueref, &arglist[2].uint);
-            else
-                arglist[3].opaqueref = glk_window_iterate(arglist[0].opaqueref, NULL);
-            break;
-        case 0x0021: /* window_get_rock */
-            arglist[2].uint = glk_window_get_rock(arglist[0].opaqueref);
-            break;
-        case 0x0022: /* window_get_root */
-            arglist[1].opaqueref = glk_window_get_root();
-            break;
-        case 0x0023: /* window_open */
-            arglist[6].opaqueref = glk_window_open(arglist[0].opaqueref, arglist[1].uint, 
-                arglist[2].uint, arglist[3].uint, arglist[4].uint);
-            break;
-        case 0x0024: /* window_close */
-            if (arglist[1].ptrflag) {
-                stream_result_t dat;
-                glk_window_close(arglist[0].opaqueref, &dat);
-                arglist[2].uint = dat.readcount;
-                arglist[3].uint = dat.writecount;
-            }
-            else {
-                glk_window_close(arglist[0].opaqueref, NULL);
-            }
-            break;
-        case 0x0025: /* window_get_size */
-            {
-                int ix = 1;
-                glui32 *ptr1, *ptr2;
-                if (!arglist[ix].ptrflag) {
-                    ptr1 = NULL;
-                }
-                else {
-                    ix++;
-                    ptr1 = &(arglist[ix].uint);
-                }
-                ix++;
-                if (!arglist[ix].ptrflag) {
-                    ptr2 = NULL;
-                }
-                else {
-                    ix++;
-                    ptr2 = &(arglist[ix].uint);
-                }
-                ix++;
-                glk_window_get_size(arglist[0].opaqueref, ptr1, ptr2);
-            }
-            break;
-        case 0x0026: /* window_set_arrangement */
-            glk_window_set_arrangement(arglist[0].opaqueref, arglist[1].uint, 
-                arglist[2].uint, arglist[3].opaqueref);
-            break;
-        case 0x0027: /* window_get_arrangement */
-            {
-                int ix = 1;
-                glui32 *ptr1, *ptr2;
-                winid_t *ptr3;
-                if (!arglist[ix].ptrflag) {
-                    ptr1 = NULL;
-                }
-                else {
-                    ix++;
-                    ptr1 = &(arglist[ix].uint);
-                }
-                ix++;
-                if (!arglist[ix].ptrflag) {
-                    ptr2 = NULL;
-                }
-                else {
-                    ix++;
-                    ptr2 = &(arglist[ix].uint);
-                }
-                ix++;
-                if (!arglist[ix].ptrflag) {
-                    ptr3 = NULL;
-                }
-                else {
-                    ix++;
-                    ptr3 = (winid_t *)(&(arglist[ix].opaqueref));
-                }
-                ix++;
-                glk_window_get_arrangement(arglist[0].opaqueref, ptr1, ptr2, ptr3);
-            }
-            break;
-        case 0x0028: /* window_get_type */
-            arglist[2].uint = glk_window_get_type(arglist[0].opaqueref);
-            break;
-        case 0x0029: /* window_get_parent */
-            arglist[2].opaqueref = glk_window_get_parent(arglist[0].opaqueref);
-            break;
-        case 0x002A: /* window_clear */
-            glk_window_clear(arglist[0].opaqueref);
-            break;
-        case 0x002B: /* window_move_cursor */
-            glk_window_move_cursor(arglist[0].opaqueref, arglist[1].uint, 
-                arglist[2].uint);
-            break;
-        case 0x002C: /* window_get_stream */
-            arglist[2].opaqueref = glk_window_get_stream(arglist[0].opaqueref);
-            break;
-        case 0x002D: /* window_set_echo_stream */
-            glk_window_set_echo_stream(arglist[0].opaqueref, arglist[1].opaqueref);
-            break;
-        case 0x002E: /* window_get_echo_stream */
-            arglist[2].opaqueref = glk_window_get_echo_stream(arglist[0].opaqueref);
-            break;
-        case 0x002F: /* set_window */
-            glk_set_window(arglist[0].opaqueref);
-            break;
-        case 0x0030: /* window_get_sibling */
-            arglist[2].opaqueref = glk_window_get_sibling(arglist[0].opaqueref);
-            break;
-        case 0x0040: /* stream_iterate */
-            if (arglist[1].ptrflag) 
-                arglist[4].opaqueref = glk_stream_iterate(arglist[0].opaqueref, &arglist[2].uint);
-            else
-                arglist[3].opaqueref = glk_stream_iterate(arglist[0].opaqueref, NULL);
-            break;
-        case 0x0041: /* stream_get_rock */
-            arglist[2].uint = glk_stream_get_rock(arglist[0].opaqueref);
-            break;
-        case 0x0042: /* stream_open_file */
-            arglist[4].opaqueref = glk_stream_open_file(arglist[0].opaqueref, arglist[1].uint, 
-                arglist[2].uint);
-            break;
-        case 0x0043: /* stream_open_memory */
-            if (arglist[0].ptrflag) 
-                arglist[6].opaqueref = glk_stream_open_memory(arglist[1].array, 
-                    arglist[2].uint, arglist[3].uint, arglist[4].uint);
-            else
-                arglist[4].opaqueref = glk_stream_open_memory(NULL, 
-                    0, arglist[1].uint, arglist[2].uint);
-            break;
-        case 0x0044: /* stream_close */
-            if (arglist[1].ptrflag) {
-                stream_result_t dat;
-                glk_stream_close(arglist[0].opaqueref, &dat);
-                arglist[2].uint = dat.readcount;
-                arglist[3].uint = dat.writecount;
-            }
-            else {
-                glk_stream_close(arglist[0].opaqueref, NULL);
-            }
-            break;
-        case 0x0045: /* stream_set_position */
-            glk_stream_set_position(arglist[0].opaqueref, arglist[1].sint,
-                arglist[2].uint);
-            break;
-        case 0x0046: /* stream_get_position */
-            arglist[2].uint = glk_stream_get_position(arglist[0].opaqueref);
-            break;
-        case 0x0047: /* stream_set_current */
-            glk_stream_set_current(arglist[0].opaqueref);
-            break;
-        case 0x0048: /* stream_get_current */
-            arglist[1].opaqueref = glk_stream_get_current();
-            break;
-        case 0x0060: /* fileref_create_temp */
-            arglist[3].opaqueref = glk_fileref_create_temp(arglist[0].uint, 
-                arglist[1].uint);
-            break;
-        case 0x0061: /* fileref_create_by_name */
-            arglist[4].opaqueref = glk_fileref_create_by_name(arglist[0].uint, 
-                arglist[1].charstr, arglist[2].uint);
-            break;
-        case 0x0062: /* fileref_create_by_prompt */
-            arglist[4].opaqueref = glk_fileref_create_by_prompt(arglist[0].uint, 
-                arglist[1].uint, arglist[2].uint);
-            break;
-        case 0x0063: /* fileref_destroy */
-            glk_fileref_destroy(arglist[0].opaqueref);
-            break;
-        case 0x0064: /* fileref_iterate */
-            if (arglist[1].ptrflag) 
-                arglist[4].opaqueref = glk_fileref_iterate(arglist[0].opaqueref, &arglist[2].uint);
-            else
-                arglist[3].opaqueref = glk_fileref_iterate(arglist[0].opaqueref, NULL);
-            break;
-        case 0x0065: /* fileref_get_rock */
-            arglist[2].uint = glk_fileref_get_rock(arglist[0].opaqueref);
-            break;
-        case 0x0066: /* fileref_delete_file */
-            glk_fileref_delete_file(arglist[0].opaqueref);
-            break;
-        case 0x0067: /* fileref_does_file_exist */
-            arglist[2].uint = glk_fileref_does_file_exist(arglist[0].opaqueref);
-            break;
-        case 0x0068: /* fileref_create_from_fileref */
-            arglist[4].opaqueref = glk_fileref_create_from_fileref(arglist[0].uint, 
-                arglist[1].opaqueref, arglist[2].uint);
-            break;
-        case 0x0080: /* put_char */
-            glk_put_char(arglist[0].uch);
-            break;
-        case 0x0081: /* put_char_stream */
-            glk_put_char_stream(arglist[0].opaqueref, arglist[1].uch);
-            break;
-        case 0x0082: /* put_string */
-            glk_put_string(arglist[0].charstr);
-            break;
-        case 0x0083: /* put_string_stream */
-            glk_put_string_stream(arglist[0].opaqueref, arglist[1].charstr);
-            break;
-        case 0x0084: /* put_buffer */
-            if (arglist[0].ptrflag) 
-                glk_put_buffer(arglist[1].array, arglist[2].uint);
-            else
-                glk_put_buffer(NULL, 0);
-            break;
-        case 0x0085: /* put_buffer_stream */
-            if (arglist[1].ptrflag) 
-                glk_put_buffer_stream(arglist[0].opaqueref, 
-                    arglist[2].array, arglist[3].uint);
-            else
-                glk_put_buffer_stream(arglist[0].opaqueref, 
-                    NULL, 0);
-            break;
-        case 0x0086: /* set_style */
-            glk_set_style(arglist[0].uint);
-            break;
-        case 0x0087: /* set_style_stream */
-            glk_set_style_stream(arglist[0].opaqueref, arglist[1].uint);
-            break;
-        case 0x0090: /* get_char_stream */
-            arglist[2].sint = glk_get_char_stream(arglist[0].opaqueref);
-            break;
-        case 0x0091: /* get_line_stream */
-            if (arglist[1].ptrflag) 
-                arglist[5].uint = glk_get_line_stream(arglist[0].opaqueref, 
-                    arglist[2].array, arglist[3].uint);
-            else
-                arglist[3].uint = glk_get_line_stream(arglist[0].opaqueref, 
-                    NULL, 0);
-            break;
-        case 0x0092: /* get_buffer_stream */
-            if (arglist[1].ptrflag) 
-                arglist[5].uint = glk_get_buffer_stream(arglist[0].opaqueref, 
-                    arglist[2].array, arglist[3].uint);
-            else
-                arglist[3].uint = glk_get_buffer_stream(arglist[0].opaqueref, 
-                    NULL, 0);
-            break;
-        case 0x00A0: /* char_to_lower */
-            arglist[2].uch = glk_char_to_lower(arglist[0].uch);
-            break;
-        case 0x00A1: /* char_to_upper */
-            arglist[2].uch = glk_char_to_upper(arglist[0].uch);
-            break;
-        case 0x00B0: /* stylehint_set */
-            glk_stylehint_set(arglist[0].uint, arglist[1].uint,
-                arglist[2].uint, arglist[3].sint);
-            break;
-        case 0x00B1: /* stylehint_clear */
-            glk_stylehint_clear(arglist[0].uint, arglist[1].uint,
-                arglist[2].uint);
-            break;
-        case 0x00B2: /* style_distinguish */
-            arglist[4].uint = glk_style_distinguish(arglist[0].opaqueref, arglist[1].uint,
-                arglist[2].uint);
-            break;
-        case 0x00B3: /* style_measure */
-            if (arglist[3].ptrflag)
-                arglist[6].uint = glk_style_measure(arglist[0].opaqueref, arglist[1].uint,
-                    arglist[2].uint, &(arglist[4].uint));
-            else
-                arglist[5].uint = glk_style_measure(arglist[0].opaqueref, arglist[1].uint,
-                    arglist[2].uint, NULL);
-            break;
-        case 0x00C0: /* select */
-            if (arglist[0].ptrflag) {
-                event_t dat;
-                glk_select(&dat);
-                arglist[1].uint = dat.type;
-                arglist[2].opaqueref = dat.win;
-                arglist[3].uint = dat.val1;
-                arglist[4].uint = dat.val2;
-            }
-            else {
-                glk_select(NULL);
-            }
-            break;
-        case 0x00C1: /* select_poll */
-            if (arglist[0].ptrflag) {
-                event_t dat;
-                glk_select_poll(&dat);
-                arglist[1].uint = dat.type;
-                arglist[2].opaqueref = dat.win;
-                arglist[3].uint = dat.val1;
-                arglist[4].uint = dat.val2;
-            }
-            else {
-                glk_select_poll(NULL);
-            }
-            break;
-        case 0x00D0: /* request_line_event */
-            if (arglist[1].ptrflag)
-                glk_request_line_event(arglist[0].opaqueref, arglist[2].array,
-                    arglist[3].uint, arglist[4].uint);
-            else
-                glk_request_line_event(arglist[0].opaqueref, NULL,
-                    0, arglist[2].uint);
-            break;
-        case 0x00D1: /* cancel_line_event */
-            if (arglist[1].ptrflag) {
-                event_t dat;
-                glk_cancel_line_event(arglist[0].opaqueref, &dat);
-                arglist[2].uint = dat.type;
-                arglist[3].opaqueref = dat.win;
-                arglist[4].uint = dat.val1;
-                arglist[5].uint = dat.val2;
-            }
-            else {
-                glk_cancel_line_event(arglist[0].opaqueref, NULL);
-            }
-            break;
-        case 0x00D2: /* request_char_event */
-            glk_request_char_event(arglist[0].opaqueref);
-            break;
-        case 0x00D3: /* cancel_char_event */
-            glk_cancel_char_event(arglist[0].opaqueref);
-            break;
-        case 0x00D4: /* request_mouse_event */
-            glk_request_mouse_event(arglist[0].opaqueref);
-            break;
-        case 0x00D5: /* cancel_mouse_event */
-            glk_cancel_mouse_event(arglist[0].opaqueref);
-            break;
-        case 0x00D6: /* request_timer_events */
-            glk_request_timer_events(arglist[0].uint);
-            break;
-
-#ifdef GLK_MODULE_IMAGE
-        case 0x00E0: /* image_get_info */
-            {
-                int ix = 1;
-                glui32 *ptr1, *ptr2;
-                if (!arglist[ix].ptrflag) {
-                    ptr1 = NULL;
-                }
-                else {
-                    ix++;
-                    ptr1 = &(arglist[ix].uint);
-                }
-                ix++;
-                if (!arglist[ix].ptrflag) {
-                    ptr2 = NULL;
-                }
-                else {
-                    ix++;
-                    ptr2 = &(arglist[ix].uint);
-                }
-                ix++;
-                ix++;
-                arglist[ix].uint = glk_image_get_info(arglist[0].uint, ptr1, ptr2);
-            }
-            break;
-        case 0x00E1: /* image_draw */
-            arglist[5].uint = glk_image_draw(arglist[0].opaqueref, 
-                arglist[1].uint,
-                arglist[2].sint, arglist[3].sint);
-            break;
-        case 0x00E2: /* image_draw_scaled */
-            arglist[7].uint = glk_image_draw_scaled(arglist[0].opaqueref, 
-                arglist[1].uint,
-                arglist[2].sint, arglist[3].sint,
-                arglist[4].uint, arglist[5].uint);
-            break;
-        case 0x00E8: /* window_flow_break */
-            glk_window_flow_break(arglist[0].opaqueref);
-            break;
-        case 0x00E9: /* window_erase_rect */
-            glk_window_erase_rect(arglist[0].opaqueref,
-                arglist[1].sint, arglist[2].sint,
-                arglist[3].uint, arglist[4].uint);
-            break;
-        case 0x00EA: /* window_fill_rect */
-            glk_window_fill_rect(arglist[0].opaqueref, arglist[1].uint,
-                arglist[2].sint, arglist[3].sint,
-                arglist[4].uint, arglist[5].uint);
-            break;
-        case 0x00EB: /* window_set_background_color */
-            glk_window_set_background_color(arglist[0].opaqueref, arglist[1].uint);
-            break;
-#endif /* GLK_MODULE_IMAGE */
-
-#ifdef GLK_MODULE_SOUND
-        case 0x00F0: /* schannel_iterate */
-            if (arglist[1].ptrflag) 
-                arglist[4].opaqueref = glk_schannel_iterate(arglist[0].opaqueref, &arglist[2].uint);
-            else
-                arglist[3].opaqueref = glk_schannel_iterate(arglist[0].opaqueref, NULL);
-            break;
-        case 0x00F1: /* schannel_get_rock */
-            arglist[2].uint = glk_schannel_get_rock(arglist[0].opaqueref);
-            break;
-        case 0x00F2: /* schannel_create */
-            arglist[2].opaqueref = glk_schannel_create(arglist[0].uint);
-            break;
-        case 0x00F3: /* schannel_destroy */
-            glk_schannel_destroy(arglist[0].opaqueref);
-            break;
-        case 0x00F8: /* schannel_play */
-            arglist[3].uint = glk_schannel_play(arglist[0].opaqueref, arglist[1].uint);
-            break;
-        case 0x00F9: /* schannel_play_ext */
-            arglist[5].uint = glk_schannel_play_ext(arglist[0].opaqueref, 
-                arglist[1].uint, arglist[2].uint, arglist[3].uint);
-            break;
-        case 0x00FA: /* schannel_stop */
-            glk_schannel_stop(arglist[0].opaqueref);
-            break;
-        case 0x00FB: /* schannel_set_volume */
-            glk_schannel_set_volume(arglist[0].opaqueref, arglist[1].uint);
-            break;
-        case 0x00FC: /* sound_load_hint */
-            glk_sound_load_hint(arglist[0].uint, arglist[1].uint);
-            break;
-
-#ifdef GLK_MODULE_SOUND2
-        case 0x00F4: /* schannel_create_ext */
-            arglist[3].opaqueref = glk_schannel_create_ext(arglist[0].uint, arglist[1].uint);
-            break;
-        case 0x00F7: /* schannel_play_multi */
-            if (arglist[0].ptrflag && arglist[3].ptrflag)
-                arglist[8].uint = glk_schannel_play_multi(arglist[1].array, arglist[2].uint, arglist[4].array, arglist[5].uint, arglist[6].uint);
-            else if (arglist[0].ptrflag)
-                arglist[6].uint = glk_schannel_play_multi(arglist[1].array, arglist[2].uint, NULL, 0, arglist[4].uint);
-            else if (arglist[1].ptrflag)
-                arglist[6].uint = glk_schannel_play_multi(NULL, 0, arglist[2].array, arglist[3].uint, arglist[4].uint);
-            else
-                arglist[4].uint = glk_schannel_play_multi(NULL, 0, NULL, 0, arglist[2].uint);
-            break;
-        case 0x00FD: /* schannel_set_volume_ext */
-            glk_schannel_set_volume_ext(arglist[0].opaqueref, arglist[1].uint, arglist[2].uint, arglist[3].uint);
-            break;
-        case 0x00FE: /* schannel_pause */
-            glk_schannel_pause(arglist[0].opaqueref);
-            break;
-        case 0x00FF: /* schannel_unpause */
-            glk_schannel_unpause(arglist[0].opaqueref);
-            break;
-#endif /* GLK_MODULE_SOUND2 */
-#endif /* GLK_MODULE_SOUND */
-
-#ifdef GLK_MODULE_HYPERLINKS
-        case 0x0100: /* set_hyperlink */
-            glk_set_hyperlink(arglist[0].uint);
-            break;
-        case 0x0101: /* set_hyperlink_stream */
-            glk_set_hyperlink_stream(arglist[0].opaqueref, arglist[1].uint);
-            break;
-        case 0x0102: /* request_hyperlink_event */
-            glk_request_hyperlink_event(arglist[0].opaqueref);
-            break;
-        case 0x0103: /* cancel_hyperlink_event */
-            glk_cancel_hyperlink_event(arglist[0].opaqueref);
-            break;
-#endif /* GLK_MODULE_HYPERLINKS */
-            
-#ifdef GLK_MODULE_UNICODE
-        case 0x0120: /* buffer_to_lower_case_uni */
-            if (arglist[0].ptrflag) 
-                arglist[5].uint = glk_buffer_to_lower_case_uni(arglist[1].array, arglist[2].uint, arglist[3].uint);
-            else
-                arglist[3].uint = glk_buffer_to_lower_case_uni(NULL, 0, arglist[1].uint);
-            break;
-        case 0x0121: /* buffer_to_upper_case_uni */
-            if (arglist[0].ptrflag) 
-                arglist[5].uint = glk_buffer_to_upper_case_uni(arglist[1].array, arglist[2].uint, arglist[3].uint);
-            else
-                arglist[3].uint = glk_buffer_to_upper_case_uni(NULL, 0, arglist[1].uint);
-            break;
-        case 0x0122: /* buffer_to_title_case_uni */
-            if (arglist[0].ptrflag) 
-                arglist[6].uint = glk_buffer_to_title_case_uni(arglist[1].array, arglist[2].uint, arglist[3].uint, arglist[4].uint);
-            else
-                arglist[4].uint = glk_buffer_to_title_case_uni(NULL, 0, arglist[1].uint, arglist[2].uint);
-            break;
-        case 0x0128: /* put_char_uni */
-            glk_put_char_uni(arglist[0].uint);
-            break;
-        case 0x0129: /* put_string_uni */
-            glk_put_string_uni(arglist[0].unicharstr);
-            break;
-        case 0x012A: /* put_buffer_uni */
-            if (arglist[0].ptrflag) 
-                glk_put_buffer_uni(arglist[1].array, arglist[2].uint);
-            else
-                glk_put_buffer_uni(NULL, 0);
-            break;
-        case 0x012B: /* put_char_stream_uni */
-            glk_put_char_stream_uni(arglist[0].opaqueref, arglist[1].uint);
-            break;
-        case 0x012C: /* put_string_stream_uni */
-            glk_put_string_stream_uni(arglist[0].opaqueref, arglist[1].unicharstr);
-            break;
-        case 0x012D: /* put_buffer_stream_uni */
-            if (arglist[1].ptrflag) 
-                glk_put_buffer_stream_uni(arglist[0].opaqueref, 
-                    arglist[2].array, arglist[3].uint);
-            else
-                glk_put_buffer_stream_uni(arglist[0].opaqueref, 
-                    NULL, 0);
-            break;
-        case 0x0130: /* get_char_stream_uni */
-            arglist[2].sint = glk_get_char_stream_uni(arglist[0].opaqueref);
-            break;
-        case 0x0131: /* get_buffer_stream_uni */
-            if (arglist[1].ptrflag) 
-                arglist[5].uint = glk_get_buffer_stream_uni(arglist[0].opaqueref, 
-                    arglist[2].array, arglist[3].uint);
-            else
-                arglist[3].uint = glk_get_buffer_stream_uni(arglist[0].opaqueref, 
-                    NULL, 0);
-            break;
-        case 0x0132: /* get_line_stream_uni */
-            if (arglist[1].ptrflag) 
-                arglist[5].uint = glk_get_line_stream_uni(arglist[0].opaqueref, 
-                    arglist[2].array, arglist[3].uint);
-            else
-                arglist[3].uint = glk_get_line_stream_uni(arglist[0].opaqueref, 
-                    NULL, 0);
-            break;
-        case 0x0138: /* stream_open_file_uni */
-            arglist[4].opaqueref = glk_stream_open_file_uni(arglist[0].opaqueref, arglist[1].uint, 
-                arglist[2].uint);
-            break;
-        case 0x0139: /* stream_open_memory_uni */
-            if (arglist[0].ptrflag) 
-                arglist[6].opaqueref = glk_stream_open_memory_uni(arglist[1].array, 
-                    arglist[2].uint, arglist[3].uint, arglist[4].uint);
-            else
-                arglist[4].opaqueref = glk_stream_open_memory_uni(NULL, 
-                    0, arglist[1].uint, arglist[2].uint);
-            break;
-        case 0x0140: /* request_char_event_uni */
-            glk_request_char_event_uni(arglist[0].opaqueref);
-            break;
-        case 0x0141: /* request_line_event_uni */
-            if (arglist[1].ptrflag)
-                glk_request_line_event_uni(arglist[0].opaqueref, arglist[2].array,
-                    arglist[3].uint, arglist[4].uint);
-            else
-                glk_request_line_event_uni(arglist[0].opaqueref, NULL,
-                    0, arglist[2].uint);
-            break;
-#endif /* GLK_MODULE_UNICODE */
-
-#ifdef GLK_MODULE_UNICODE_NORM
-        case 0x0123: /* buffer_canon_decompose_uni */
-            if (arglist[0].ptrflag) 
-                arglist[5].uint = glk_buffer_canon_decompose_uni(arglist[1].array, arglist[2].uint, arglist[3].uint);
-            else
-                arglist[3].uint = glk_buffer_canon_decompose_uni(NULL, 0, arglist[1].uint);
-            break;
-        case 0x0124: /* buffer_canon_normalize_uni */
-            if (arglist[0].ptrflag) 
-                arglist[5].uint = glk_buffer_canon_normalize_uni(arglist[1].array, arglist[2].uint, arglist[3].uint);
-            else
-                arglist[3].uint = glk_buffer_canon_normalize_uni(NULL, 0, arglist[1].uint);
-            break;
-#endif /* GLK_MODULE_UNICODE_NORM */
-            
-#ifdef GLK_MODULE_LINE_ECHO
-        case 0x0150: /* set_echo_line_event */
-            glk_set_echo_line_event(arglist[0].opaqueref, arglist[1].uint);
-            break;
-#endif /* GLK_MODULE_LINE_ECHO */
-
-#ifdef GLK_MODULE_LINE_TERMINATORS
-        case 0x0151: /* set_terminators_line_event */
-            if (arglist[1].ptrflag) 
-                glk_set_terminators_line_event(arglist[0].opaqueref, 
-                    arglist[2].array, arglist[3].uint);
-            else
-                glk_set_terminators_line_event(arglist[0].opaqueref, 
-                    NULL, 0);
-            break;
-#endif /* GLK_MODULE_LINE_TERMINATORS */
-            
-#ifdef GLK_MODULE_DATETIME
-        case 0x0160: /* current_time */
-            if (arglist[0].ptrflag) {
-                glktimeval_t dat;
-                glk_current_time(&dat);
-                arglist[1].sint = dat.high_sec;
-                arglist[2].uint = dat.low_sec;
-                arglist[3].sint = dat.microsec;
-            }
-            else {
-                glk_current_time(NULL);
-            }
-            break;
-        case 0x0161: /* current_simple_time */
-            arglist[2].sint = glk_current_simple_time(arglist[0].uint);
-            break;
-        case 0x0168: /* time_to_date_utc */ {
-            glktimeval_t timeval;
-            glktimeval_t *timeptr = NULL;
-            glkdate_t date;
-            glkdate_t *dateptr = NULL;
-            int ix = 0;
-            if (arglist[ix++].ptrflag) {
-                timeptr = &timeval;
-                timeval.high_sec = arglist[ix++].sint;
-                timeval.low_sec = arglist[ix++].uint;
-                timeval.microsec = arglist[ix++].sint;
-            }
-            if (arglist[ix++].ptrflag) {
-                dateptr = &date;
-            }
-            glk_time_to_date_utc(timeptr, dateptr);
-            if (dateptr) {
-                arglist[ix++].sint = date.year;
-                arglist[ix++].sint = date.month;
-                arglist[ix++].sint = date.day;
-                arglist[ix++].sint = date.weekday;
-                arglist[ix++].sint = date.hour;
-                arglist[ix++].sint = date.minute;
-                arglist[ix++].sint = date.second;
-                arglist[ix++].sint = date.microsec;
-            }
-            }
-            break;
-        case 0x0169: /* time_to_date_local */ {
-            glktimeval_t timeval;
-            glktimeval_t *timeptr = NULL;
-            glkdate_t date;
-            glkdate_t *dateptr = NULL;
-            int ix = 0;
-            if (arglist[ix++].ptrflag) {
-                timeptr = &timeval;
-                timeval.high_sec = arglist[ix++].sint;
-                timeval.low_sec = arglist[ix++].uint;
-                timeval.microsec = arglist[ix++].sint;
-            }
-            if (arglist[ix++].ptrflag) {
-                dateptr = &date;
-            }
-            glk_time_to_date_local(timeptr, dateptr);
-            if (dateptr) {
-                arglist[ix++].sint = date.year;
-                arglist[ix++].sint = date.month;
-                arglist[ix++].sint = date.day;
-                arglist[ix++].sint = date.weekday;
-                arglist[ix++].sint = date.hour;
-                arglist[ix++].sint = date.minute;
-                arglist[ix++].sint = date.second;
-                arglist[ix++].sint = date.microsec;
-            }
-            }
-            break;
-        case 0x016A: /* simple_time_to_date_utc */ {
-            glkdate_t date;
-            glkdate_t *dateptr = NULL;
-            int ix = 2;
-            if (arglist[ix++].ptrflag) {
-                dateptr = &date;
-            }
-            glk_simple_time_to_date_utc(arglist[0].sint, arglist[1].uint, dateptr);
-            if (dateptr) {
-                arglist[ix++].sint = date.year;
-                arglist[ix++].sint = date.month;
-                arglist[ix++].sint = date.day;
-                arglist[ix++].sint = date.weekday;
-                arglist[ix++].sint = date.hour;
-                arglist[ix++].sint = date.minute;
-                arglist[ix++].sint = date.second;
-                arglist[ix++].sint = date.microsec;
-            }
-            }
-            break;
-        case 0x016B: /* simple_time_to_date_local */ {
-            glkdate_t date;
-            glkdate_t *dateptr = NULL;
-            int ix = 2;
-            if (arglist[ix++].ptrflag) {
-                dateptr = &date;
-            }
-            glk_simple_time_to_date_local(arglist[0].sint, arglist[1].uint, dateptr);
-            if (dateptr) {
-                arglist[ix++].sint = date.year;
-                arglist[ix++].sint = date.month;
-                arglist[ix++].sint = date.day;
-                arglist[ix++].sint = date.weekday;
-                arglist[ix++].sint = date.hour;
-                arglist[ix++].sint = date.minute;
-                arglist[ix++].sint = date.second;
-                arglist[ix++].sint = date.microsec;
-            }
-            }
-            break;
-        case 0x016C: /* date_to_time_utc */ {
-            glkdate_t date;
-            glkdate_t *dateptr = NULL;
-            glktimeval_t timeval;
-            glktimeval_t *timeptr = NULL;
-            int ix = 0;
-            if (arglist[ix++].ptrflag) {
-                dateptr = &date;
-                date.year = arglist[ix++].sint;
-                date.month = arglist[ix++].sint;
-                date.day = arglist[ix++].sint;
-                date.weekday = arglist[ix++].sint;
-                date.hour = arglist[ix++].sint;
-                date.minute = arglist[ix++].sint;
-                date.second = arglist[ix++].sint;
-                date.microsec = arglist[ix++].sint;
-            }
-            if (arglist[ix++].ptrflag) {
-                timeptr = &timeval;
-            }
-            glk_date_to_time_utc(dateptr, timeptr);
-            if (timeptr) {
-                arglist[ix++].sint = timeval.high_sec;
-                arglist[ix++].uint = timeval.low_sec;
-                arglist[ix++].sint = timeval.microsec;
-            }
-            }
-            break;
-        case 0x016D: /* date_to_time_local */ {
-            glkdate_t date;
-            glkdate_t *dateptr = NULL;
-            glktimeval_t timeval;
-            glktimeval_t *timeptr = NULL;
-            int ix = 0;
-            if (arglist[ix++].ptrflag) {
-                dateptr = &date;
-                date.year = arglist[ix++].sint;
-                date.month = arglist[ix++].sint;
-                date.day = arglist[ix++].sint;
-                date.weekday = arglist[ix++].sint;
-                date.hour = arglist[ix++].sint;
-                date.minute = arglist[ix++].sint;
-                date.second = arglist[ix++].sint;
-                date.microsec = arglist[ix++].sint;
-            }
-            if (arglist[ix++].ptrflag) {
-                timeptr = &timeval;
-            }
-            glk_date_to_time_local(dateptr, timeptr);
-            if (timeptr) {
-                arglist[ix++].sint = timeval.high_sec;
-                arglist[ix++].uint = timeval.low_sec;
-                arglist[ix++].sint = timeval.microsec;
-            }
-            }
-            break;
-        case 0x016E: /* date_to_simple_time_utc */ {
-            glkdate_t date;
-            glkdate_t *dateptr = NULL;
-            int ix = 0;
-            if (arglist[ix++].ptrflag) {
-                dateptr = &date;
-                date.year = arglist[ix++].sint;
-                date.month = arglist[ix++].sint;
-                date.day = arglist[ix++].sint;
-                date.weekday = arglist[ix++].sint;
-                date.hour = arglist[ix++].sint;
-                date.minute = arglist[ix++].sint;
-                date.second = arglist[ix++].sint;
-                date.microsec = arglist[ix++].sint;
-            }
-            arglist[ix+2].sint = glk_date_to_simple_time_utc(dateptr, arglist[ix].uint);
-            }
-            break;
-        case 0x016F: /* date_to_simple_time_local */ {
-            glkdate_t date;
-            glkdate_t *dateptr = NULL;
-            int ix = 0;
-            if (arglist[ix++].ptrflag) {
-                dateptr = &date;
-                date.year = arglist[ix++].sint;
-                date.month = arglist[ix++].sint;
-                date.day = arglist[ix++].sint;
-                date.weekday = arglist[ix++].sint;
-                date.hour = arglist[ix++].sint;
-                date.minute = arglist[ix++].sint;
-                date.second = arglist[ix++].sint;
-                date.microsec = arglist[ix++].sint;
-            }
-            arglist[ix+2].sint = glk_date_to_simple_time_local(dateptr, arglist[ix].uint);
-            }
-            break;
-#endif /* GLK_MODULE_DATETIME */
-
-#ifdef GLK_MODULE_RESOURCE_STREAM
-        case 0x0049: /* stream_open_resource */
-            arglist[3].opaqueref = glk_stream_open_resource(arglist[0].uint, arglist[1].uint);
-            break;
-        case 0x013A: /* stream_open_resource_uni */
-            arglist[3].opaqueref = glk_stream_open_resource_uni(arglist[0].uint, arglist[1].uint);
-            break;
-#endif /* GLK_MODULE_RESOURCE_STREAM */
-
-#ifdef GLK_EXTEND_CALL
-        GLK_EXTEND_CALL
-#endif /* GLK_EXTEND_CALL */
-
-        default:
-            /* do nothing */
-            break;
-    }
-}
+/* gidispatch_call() is defined in dispatchstub.cpp, which calls a stub
+    generated for each function from a description of its arguments. */
 
 #ifdef GI_DISPA_GAME_ID_AVAILABLE
 
@@ -130,6 +130,9 @@ glui32 glk_gestalt_ext(glui32 id, glui32 val, glui32* arr, glui32 arrlen) {
         case gestalt_SoundMusic:
             return TRUE;
 
+        case gestalt_SoundNotify:
+            return TRUE;
+
         case gestalt_SoundVolume:
             return TRUE;
 
@@ -3,7 +3,6 @@
 
 #include <cstddef>
 
-#include <map>
 #include <sstream>
 
 #include <QByteArray>
@@ -24,11 +23,16 @@ extern "C" {
 #include "gi_dispa.h"
 }
 
+#include "arrayregistry.hpp"
+
 // Q_DECLARE_METATYPE(glui32)
 
 namespace Glk {
     class Object;
 
+    template<typename T>
+    class ObjectTable;
+
     class Dispatch {
         using ObjectRegisterFunction = gidispatch_rock_t(void*, glui32);
         using ObjectUnregisterFunction = void(void*, glui32, gidispatch_rock_t);
@@ -51,7 +55,7 @@ namespace Glk {
             ObjectRegisterFunction* mf_RegisterObject{nullptr};
             ObjectUnregisterFunction* mf_UnregisterObject{nullptr};
 
-            std::map<void*, gidispatch_rock_t> m_ArrayRegistry{};
+            ArrayRegistry m_ArrayRegistry{};
             ArrayRegisterFunction* mf_RegisterArray{nullptr};
             ArrayUnregisterFunction* mf_UnregisterArray{nullptr};
     };
@@ -60,6 +64,8 @@ namespace Glk {
             Q_DISABLE_COPY(Object)
 
             friend class Dispatch;
+            template<typename T>
+            friend class ObjectTable;
 
         public:
             enum Type : glui32 {
@@ -85,7 +91,21 @@ namespace Glk {
         private:
             glui32 m_Rock;
             gidispatch_rock_t m_DispatchRock;
+
+            /* where the object sits in its ObjectTable */
+            glui32 m_TableSlot{~glui32(0)};
     };
+
+    /// Whether the ids passed to the glk API are checked against the object tables, which is turned on by setting
+    ///   QGLK_VALIDATE_HANDLES=1 at startup.
+    [[nodiscard]] inline bool validatingHandles() {
+        static const bool validating = qEnvironmentVariableIntValue("QGLK_VALIDATE_HANDLES") != 0;
+
+        return validating;
+    }
+
+    /// Exits when id is not a live object of the given type. Only called while validatingHandles().
+    void validateHandle(const void* id, Object::Type type);
 }
 
 template<typename T>
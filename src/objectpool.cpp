@@ -0,0 +1,11 @@
+#include "objectpool.hpp"
+
+#include "qglk.hpp"
+
+void* Glk::PoolAllocated::operator new(std::size_t size) {
+    return QGlk::getMainWindow().objectPool().allocate(size);
+}
+
+void Glk::PoolAllocated::operator delete(void* ptr, std::size_t size) {
+    QGlk::getMainWindow().objectPool().deallocate(ptr, size);
+}
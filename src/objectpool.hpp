@@ -0,0 +1,72 @@
+#ifndef OBJECTPOOL_HPP
+#define OBJECTPOOL_HPP
+
+#include <array>
+#include <cstddef>
+#include <new>
+#include <vector>
+
+#include <QtGlobal>
+
+namespace Glk {
+    /// Recycles the memory of objects that are created and destroyed at a high rate, such as the memory streams
+    ///   glulxe opens for every string it prints to a buffer. Freed blocks are kept on a free list for their size,
+    ///   so once every size has been seen, allocating is popping a block off its list. Only used from the glk
+    ///   thread.
+    class ObjectPool {
+            static constexpr std::size_t GRANULARITY = alignof(std::max_align_t);
+            static constexpr std::size_t MAX_SIZE = 512; /* larger objects go straight to the heap */
+
+        public:
+            ObjectPool() = default;
+
+            ~ObjectPool() {
+                for(auto& freeList : m_FreeLists)
+                    for(void* block : freeList)
+                        ::operator delete(block);
+            }
+
+            Q_DISABLE_COPY(ObjectPool)
+
+
+            [[nodiscard]] void* allocate(std::size_t size) {
+                if(size == 0 || size > MAX_SIZE)
+                    return ::operator new(size);
+
+                auto& freeList = m_FreeLists[sizeClass(size)];
+                if(freeList.empty())
+                    return ::operator new((sizeClass(size) + 1) * GRANULARITY);
+
+                void* block = freeList.back();
+                freeList.pop_back();
+                return block;
+            }
+
+            void deallocate(void* ptr, std::size_t size) {
+                if(size == 0 || size > MAX_SIZE) {
+                    ::operator delete(ptr);
+                    return;
+                }
+
+                m_FreeLists[sizeClass(size)].push_back(ptr);
+            }
+
+        private:
+            [[nodiscard]] static inline std::size_t sizeClass(std::size_t size) {
+                return (size - 1) / GRANULARITY;
+            }
+
+
+            std::array<std::vector<void*>, MAX_SIZE / GRANULARITY> m_FreeLists;
+    };
+
+    /// Makes new and delete of a class, and of everything derived from it, go through the session's ObjectPool.
+    class PoolAllocated {
+        public:
+            static void* operator new(std::size_t size);
+
+            static void operator delete(void* ptr, std::size_t size);
+    };
+}
+
+#endif //OBJECTPOOL_HPP
@@ -0,0 +1,135 @@
+#ifndef OBJECTTABLE_HPP
+#define OBJECTTABLE_HPP
+
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <unordered_set>
+#include <vector>
+
+#include "glk.hpp"
+
+namespace Glk {
+    /// The live objects of one class, in the order they were created. Every object remembers its slot in the
+    ///   table, so adding one, removing one and finding the one after it are all O(1). Ids are the object pointers,
+    ///   so everything but isLive() reads the object itself and must only be given live ones. Telling a stale id
+    ///   apart is left to isLive(), which works while validatingHandles().
+    template<typename T>
+    class ObjectTable {
+            static_assert(std::is_base_of_v<Object, T>);
+
+            static constexpr std::uint32_t NONE = std::numeric_limits<std::uint32_t>::max();
+
+            struct Slot {
+                T* object;
+                std::uint32_t prev; /* previous live slot, or the next free one for free slots */
+                std::uint32_t next;
+            };
+
+        public:
+            ObjectTable() = default;
+
+            Q_DISABLE_COPY(ObjectTable)
+
+
+            [[nodiscard]] inline bool empty() const {
+                return m_Size == 0;
+            }
+
+            [[nodiscard]] inline std::size_t size() const {
+                return m_Size;
+            }
+
+            [[nodiscard]] inline bool contains(const T* obj) const {
+                return obj->m_TableSlot < m_Slots.size() && m_Slots[obj->m_TableSlot].object == obj;
+            }
+
+            /// Checks an id without dereferencing it, so it also works for ids of objects that no longer exist.
+            ///   Only possible while validatingHandles().
+            [[nodiscard]] inline bool isLive(const void* id) const {
+                return m_Live.count(id) != 0;
+            }
+
+            [[nodiscard]] inline T* first() const {
+                return m_Head == NONE ? nullptr : m_Slots[m_Head].object;
+            }
+
+            [[nodiscard]] inline T* next(const T* obj) const {
+                if(!contains(obj))
+                    return nullptr;
+
+                std::uint32_t next = m_Slots[obj->m_TableSlot].next;
+                return next == NONE ? nullptr : m_Slots[next].object;
+            }
+
+            void insert(T* obj) {
+                std::uint32_t slot = m_FreeHead;
+                if(slot != NONE) {
+                    m_FreeHead = m_Slots[slot].prev;
+                } else {
+                    slot = std::uint32_t(m_Slots.size());
+                    m_Slots.push_back(Slot{nullptr, NONE, NONE});
+                }
+
+                Slot& s = m_Slots[slot];
+                s.object = obj;
+                s.prev = m_Tail;
+                s.next = NONE;
+
+                if(m_Tail != NONE)
+                    m_Slots[m_Tail].next = slot;
+                else
+                    m_Head = slot;
+                m_Tail = slot;
+
+                obj->m_TableSlot = slot;
+                m_Size++;
+
+                if(validatingHandles())
+                    m_Live.insert(obj);
+            }
+
+            /// Returns false when the object is not in the table.
+            bool remove(T* obj) {
+                if(!contains(obj))
+                    return false;
+
+                std::uint32_t slot = obj->m_TableSlot;
+                Slot& s = m_Slots[slot];
+
+                if(s.prev != NONE)
+                    m_Slots[s.prev].next = s.next;
+                else
+                    m_Head = s.next;
+
+                if(s.next != NONE)
+                    m_Slots[s.next].prev = s.prev;
+                else
+                    m_Tail = s.prev;
+
+                s.object = nullptr;
+                s.prev = m_FreeHead;
+                s.next = NONE;
+                m_FreeHead = slot;
+
+                obj->m_TableSlot = NONE;
+                m_Size--;
+
+                if(validatingHandles())
+                    m_Live.erase(obj);
+
+                return true;
+            }
+
+        private:
+            std::vector<Slot> m_Slots;
+            std::uint32_t m_Head{NONE};
+            std::uint32_t m_Tail{NONE};
+            std::uint32_t m_FreeHead{NONE};
+            std::size_t m_Size{0};
+
+            std::unordered_set<const void*> m_Live; /* only filled while validatingHandles() */
+    };
+}
+
+#endif //OBJECTTABLE_HPP
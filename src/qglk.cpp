@@ -1,7 +1,6 @@
 #include "qglk.hpp"
 #include "ui_qglk.h"
 
-#include <QResizeEvent>
 #include <QThread>
 #include <QThreadPool>
 
@@ -170,14 +169,18 @@ QGlk::QGlk(int argc, char** argv)
       mp_RootWindow{nullptr},
       m_DeleteQueue{},
       m_EventQueue{},
-      m_WindowList{},
-      m_StreamList{},
-      m_FileReferenceList{},
-      m_SoundChannelList{},
+      m_ObjectPool{},
+      m_WindowTable{},
+      m_StreamTable{},
+      m_FileReferenceTable{},
+      m_SoundChannelTable{},
       m_InterruptHandler{},
+      m_ImageCacheMutex{},
       m_ImageCache{512*1024*1024}, /* image cache of up to 512 MiB */
+      m_Prefetcher{},
       m_DefaultStyles{},
       m_TextBufferStyles{},
+      m_TextGridStyles{},
       m_Dispatch{} {
     setMinimumSize(800, 600);
     mp_UI->setupUi(this);
@@ -191,38 +194,122 @@ QGlk::QGlk(int argc, char** argv)
 
 QGlk::~QGlk() {
     // windows contain their own window streams so we first delete windows, then streams
-    while(!m_WindowList.empty())
-        delete m_WindowList.front();
+    while(!m_WindowTable.empty())
+        delete m_WindowTable.first();
 
-    while(!m_StreamList.empty())
-        delete m_StreamList.front();
+    while(!m_StreamTable.empty())
+        delete m_StreamTable.first();
 
-    while(!m_FileReferenceList.empty())
-        delete m_FileReferenceList.front();
+    while(!m_FileReferenceTable.empty())
+        delete m_FileReferenceTable.first();
 
-    while(!m_SoundChannelList.empty())
-        delete m_SoundChannelList.front();
+    while(!m_SoundChannelTable.empty())
+        delete m_SoundChannelTable.first();
 
     delete mp_UI;
 }
 
+void Glk::validateHandle(const void* id, Glk::Object::Type type) {
+    QGlk& qglk = QGlk::getMainWindow();
+    bool live;
+
+    switch(type) {
+        case Object::Type::Window:
+            live = qglk.windowTable().isLive(id);
+            break;
+
+        case Object::Type::Stream:
+            live = qglk.streamTable().isLive(id);
+            break;
+
+        case Object::Type::FileReference:
+            live = qglk.fileReferenceTable().isLive(id);
+            break;
+
+        case Object::Type::SoundChannel:
+            live = qglk.soundChannelTable().isLive(id);
+            break;
+
+        default:
+            live = false;
+    }
+
+    if(!live) {
+        qCritical() << "Invalid id" << id << "passed for an object of type" << glui32(type);
+        glk_exit();
+    }
+}
+
 void QGlk::addToDeleteQueue(Glk::WindowController* winController) {
     if(std::find(m_DeleteQueue.begin(), m_DeleteQueue.end(), winController) == m_DeleteQueue.end())
         m_DeleteQueue.push_back(winController);
 }
 
-QImage QGlk::loadImage(glui32 image) {
-    if(m_ImageCache.contains(image)) {
-        return *m_ImageCache[image];
-    } else {
-        Glk::Blorb::Chunk imgchunk = Glk::Blorb::loadResource(image, Glk::Blorb::ResourceUsage::Picture);
-        if(!imgchunk.isValid())
-            return {};
+void QGlk::cacheImage(glui32 image, const QImage& img) {
+    QMutexLocker ml{&m_ImageCacheMutex};
 
-        QImage img = QImage::fromData(reinterpret_cast<const uchar*>(imgchunk.data()), imgchunk.length());
+    if(!m_ImageCache.contains(image))
         m_ImageCache.insert(image, new QImage{img}, img.sizeInBytes());
+}
+
+void QGlk::flushWindows() {
+    assert(Glk::onGlkThread());
+
+    if(!mp_RootWindow)
+        return;
+
+    auto fn_recursive_flush = [](auto&& this_fn, Glk::WindowController* win) mutable -> void {
+        if(win->window()->windowType() == Glk::Window::Pair) {
+            this_fn(this_fn, win->window<Glk::PairWindow>()->firstWindow()->controller());
+            this_fn(this_fn, win->window<Glk::PairWindow>()->secondWindow()->controller());
+        } else {
+            win->flushOutput();
+        }
+    };
+
+    fn_recursive_flush(fn_recursive_flush, mp_RootWindow->controller());
+}
+
+bool QGlk::isImageCached(glui32 image) {
+    QMutexLocker ml{&m_ImageCacheMutex};
+
+    return m_ImageCache.contains(image);
+}
+
+QImage QGlk::loadImage(glui32 image) {
+    m_Prefetcher.recordAccess(Glk::Blorb::ResourceUsage::Picture, image);
+
+    {
+        QMutexLocker ml{&m_ImageCacheMutex};
+
+        if(m_ImageCache.contains(image))
+            return *m_ImageCache[image];
+    }
+
+    /* pack images are used straight from the mapping, caching them would only count them against the budget */
+    if(QImage img = m_ResourcePack.image(image); !img.isNull())
+        return img;
+
+    Glk::Blorb::Chunk imgchunk = Glk::Blorb::loadResource(image, Glk::Blorb::ResourceUsage::Picture);
+    if(!imgchunk.isValid())
+        return {};
+
+    QImage img = QImage::fromData(reinterpret_cast<const uchar*>(imgchunk.data()), imgchunk.length());
+    cacheImage(image, img);
+    return img;
+}
+
+QImage QGlk::loadImage(glui32 image, QSize size) {
+    if(QImage img = m_ResourcePack.image(image, size); !img.isNull()) {
+        m_Prefetcher.recordAccess(Glk::Blorb::ResourceUsage::Picture, image);
         return img;
     }
+
+    QImage img = loadImage(image);
+    if(img.isNull() || img.size() == size)
+        return img;
+
+    return img.scaled(size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
 }
 
 void QGlk::run() {
@@ -247,6 +334,18 @@ void QGlk::synchronize() {
 
         mp_RootWindow->controller()->synchronize();
     } else {
+        /* give every window that needs it a head start first, so the slow parts run in parallel */
+        auto fn_recursive_prepare = [](auto&& this_fn, Glk::WindowController* win) mutable -> void {
+            if(win->window()->windowType() == Glk::Window::Pair && !win->requiresSynchronization()) {
+                this_fn(this_fn, win->window<Glk::PairWindow>()->firstWindow()->controller());
+                this_fn(this_fn, win->window<Glk::PairWindow>()->secondWindow()->controller());
+            } else if(win->requiresSynchronization()) {
+                win->prepareSynchronization();
+            }
+        };
+
+        fn_recursive_prepare(fn_recursive_prepare, mp_RootWindow->controller());
+
         auto fn_recursive_synchronize = [](auto&& this_fn, Glk::WindowController* win) mutable -> void {
             if(win->window()->windowType() == Glk::Window::Pair && !win->requiresSynchronization()) {
                 this_fn(this_fn, win->window<Glk::PairWindow>()->firstWindow()->controller());
@@ -259,6 +358,20 @@ void QGlk::synchronize() {
         fn_recursive_synchronize(fn_recursive_synchronize, mp_RootWindow->controller());
     }
 
+    /* windows may have been laid out anew, so their sizes are published again for glk_window_get_size */
+    if(mp_RootWindow) {
+        auto fn_recursive_update = [](auto&& this_fn, Glk::WindowController* win) mutable -> void {
+            if(win->window()->windowType() == Glk::Window::Pair) {
+                this_fn(this_fn, win->window<Glk::PairWindow>()->firstWindow()->controller());
+                this_fn(this_fn, win->window<Glk::PairWindow>()->secondWindow()->controller());
+            }
+
+            win->updateGlkSize();
+        };
+
+        fn_recursive_update(fn_recursive_update, mp_RootWindow->controller());
+    }
+
     while(!m_DeleteQueue.empty()) {
         delete m_DeleteQueue.front();
         m_DeleteQueue.pop_front();
@@ -270,12 +383,6 @@ void QGlk::closeEvent(QCloseEvent* event) {
     event->accept();
 }
 
-void QGlk::resizeEvent(QResizeEvent* event) {
-    QMainWindow::resizeEvent(event);
-
-    eventQueue().push(event_t{evtype_Arrange, NULL, 0, 0});
-}
-
 bool QGlk::handleGlkTask(Glk::TaskEvent* event) {
     event->execute();
     return event->handled();
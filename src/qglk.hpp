@@ -2,19 +2,25 @@
 #define QGLK_H
 
 #include <deque>
-#include <list>
 #include <map>
 #include <functional>
 
 #include <QCache>
 #include <QMainWindow>
+#include <QMutex>
 #include <QRunnable>
+#include <QThreadPool>
 #include <QWidget>
 
 #include <coroutine.h>
 
+#include "objectpool.hpp"
+#include "objecttable.hpp"
+#include "blorb/prefetcher.hpp"
+#include "blorb/resourcepack.hpp"
 #include "event/eventqueue.hpp"
 #include "file/fileref.hpp"
+#include "sound/mixer.hpp"
 #include "sound/schannel.hpp"
 #include "thread/taskrequest.hpp"
 #include "window/stylemanager.hpp"
@@ -64,8 +70,18 @@ class QGlk : public QMainWindow {
 
         void addToDeleteQueue(Glk::WindowController* winController);
 
+        void cacheImage(glui32 image, const QImage& img);
+
+        /// Called on the glk thread before it asks for synchronization, for every window to flush its output.
+        void flushWindows();
+
+        [[nodiscard]] bool isImageCached(glui32 image);
+
         QImage loadImage(glui32 image);
 
+        /// Loads an image at the given size, using a prescaled copy from the resource pack when there is one.
+        QImage loadImage(glui32 image, QSize size);
+
         void run();
 
 
@@ -95,6 +111,9 @@ class QGlk : public QMainWindow {
         inline Glk::StyleManager& textBufferStyleManager() {
             return m_TextBufferStyles;
         }
+        inline Glk::StyleManager& textGridStyleManager() {
+            return m_TextGridStyles;
+        }
 
         inline Glk::Dispatch& dispatch() {
             return m_Dispatch;
@@ -102,17 +121,32 @@ class QGlk : public QMainWindow {
         inline Glk::EventQueue& eventQueue() {
             return m_EventQueue;
         }
-        inline std::list<Glk::Window*>& windowList() {
-            return m_WindowList;
+        inline Glk::Blorb::Prefetcher& prefetcher() {
+            return m_Prefetcher;
+        }
+        inline Glk::Blorb::ResourcePack& resourcePack() {
+            return m_ResourcePack;
+        }
+        inline Glk::Mixer& mixer() {
+            return m_Mixer;
+        }
+        inline QThreadPool& documentBuildPool() {
+            return m_DocumentBuildPool;
+        }
+        inline Glk::ObjectPool& objectPool() {
+            return m_ObjectPool;
+        }
+        inline Glk::ObjectTable<Glk::Window>& windowTable() {
+            return m_WindowTable;
         }
-        inline std::list<Glk::Stream*>& streamList() {
-            return m_StreamList;
+        inline Glk::ObjectTable<Glk::Stream>& streamTable() {
+            return m_StreamTable;
         }
-        inline std::list<Glk::FileReference*>& fileReferenceList() {
-            return m_FileReferenceList;
+        inline Glk::ObjectTable<Glk::FileReference>& fileReferenceTable() {
+            return m_FileReferenceTable;
         }
-        inline std::list<Glk::SoundChannel*>& soundChannelList() {
-            return m_SoundChannelList;
+        inline Glk::ObjectTable<Glk::SoundChannel>& soundChannelTable() {
+            return m_SoundChannelTable;
         }
 
         bool event(QEvent* event) override;
@@ -126,7 +160,6 @@ class QGlk : public QMainWindow {
 
     protected:
         void closeEvent(QCloseEvent* event) override;
-        void resizeEvent(QResizeEvent* event) override;
 
     private:
         QGlk(int argc, char** argv);
@@ -139,16 +172,23 @@ class QGlk : public QMainWindow {
         Glk::Window* mp_RootWindow;
         std::deque<Glk::WindowController*> m_DeleteQueue;
         Glk::EventQueue m_EventQueue;
-        std::list<Glk::Window*> m_WindowList;
-        std::list<Glk::Stream*> m_StreamList;
-        std::list<Glk::FileReference*> m_FileReferenceList;
-        std::list<Glk::SoundChannel*> m_SoundChannelList;
+        Glk::ObjectPool m_ObjectPool; /* outlives the objects in the tables */
+        Glk::ObjectTable<Glk::Window> m_WindowTable;
+        Glk::ObjectTable<Glk::Stream> m_StreamTable;
+        Glk::ObjectTable<Glk::FileReference> m_FileReferenceTable;
+        Glk::ObjectTable<Glk::SoundChannel> m_SoundChannelTable;
 
         std::function<void(void)> m_InterruptHandler;
 
+        QMutex m_ImageCacheMutex;
         QCache<glui32, QImage> m_ImageCache;
+        Glk::Blorb::Prefetcher m_Prefetcher;
+        Glk::Blorb::ResourcePack m_ResourcePack;
+        Glk::Mixer m_Mixer;
+        QThreadPool m_DocumentBuildPool;
         Glk::StyleManager m_DefaultStyles;
         Glk::StyleManager m_TextBufferStyles;
+        Glk::StyleManager m_TextGridStyles;
 
         Glk::Dispatch m_Dispatch;
 };
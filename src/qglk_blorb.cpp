@@ -1,9 +1,33 @@
 #include "glk.hpp"
 
+#include <QFileInfo>
 #include <QHash>
 
+#include "qglk.hpp"
+#include "blorb/chunk.hpp"
+#include "blorb/resourcepack.hpp"
+#include "log/log.hpp"
+#include "stream/stream.hpp"
+
 giblorb_map_t* s_BlorbMap = 0; /* NULL */
 
+namespace {
+    /* the pack is looked up next to the blorb file, unless QGLK_RESOURCE_PACK points somewhere else */
+    void openResourcePack(Glk::Stream* str) {
+        QString path = qEnvironmentVariable("QGLK_RESOURCE_PACK");
+        if(path.isEmpty() && !str->filePath().empty())
+            path = QString::fromStdString(str->filePath().string() + Glk::Blorb::Pack::SUFFIX);
+
+        if(path.isEmpty() || !QFileInfo::exists(path))
+            return;
+
+        if(QGlk::getMainWindow().resourcePack().open(path, Glk::Blorb::indexFingerprint(s_BlorbMap)))
+            spdlog::info("Using resource pack {}", path);
+        else
+            spdlog::warn("Ignoring resource pack {}: it is malformed, already loaded or was built from another game", path);
+    }
+}
+
 giblorb_err_t giblorb_set_resource_map(strid_t file) {
     giblorb_err_t err = giblorb_create_map(file, &s_BlorbMap);
 
@@ -12,6 +36,8 @@ giblorb_err_t giblorb_set_resource_map(strid_t file) {
         return err;
     }
 
+    openResourcePack(FROM_STRID(file));
+
     return giblorb_err_None;
 }
 
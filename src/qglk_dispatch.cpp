@@ -73,16 +73,14 @@ const char UCS4_CODE[] = "&+#!Iu";
 
 void Glk::Dispatch::registerArray(void* ptr, glui32 len, bool unicode) {
     if(mf_RegisterArray)
-        m_ArrayRegistry[ptr] = mf_RegisterArray(ptr, len, (char*) (unicode ? UCS4_CODE : CHAR_CODE));
+        m_ArrayRegistry.insert(ptr, mf_RegisterArray(ptr, len, (char*) (unicode ? UCS4_CODE : CHAR_CODE)));
 }
 
 void Glk::Dispatch::unregisterArray(void* ptr, glui32 len, bool unicode) {
-    if(m_ArrayRegistry.find(ptr) != m_ArrayRegistry.end()) {
-        if(mf_UnregisterArray)
-            mf_UnregisterArray(ptr, len, (char*) (unicode ? UCS4_CODE : CHAR_CODE), m_ArrayRegistry[ptr]);
+    gidispatch_rock_t rock;
 
-        m_ArrayRegistry.erase(ptr);
-    }
+    if(m_ArrayRegistry.take(ptr, rock) && mf_UnregisterArray)
+        mf_UnregisterArray(ptr, len, (char*) (unicode ? UCS4_CODE : CHAR_CODE), rock);
 }
 
 
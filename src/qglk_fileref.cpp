@@ -133,37 +133,15 @@ void glk_fileref_destroy(frefid_t fref) {
 }
 
 frefid_t glk_fileref_iterate(frefid_t fref, glui32* rockptr) {
-    const auto& frefList = QGlk::getMainWindow().fileReferenceList();
+    const auto& table = QGlk::getMainWindow().fileReferenceTable();
+    auto next = fref == NULL ? table.first() : table.next(FROM_FREFID(fref));
 
-    if(fref == NULL) {
-        if(frefList.empty()) {
-            SPDLOG_TRACE("glk_fileref_iterate({}, {}) => {}", wrap::ptr(fref), wrap::ptr(rockptr), wrap::ptr(nullptr));
-            return NULL;
-        }
-
-        auto first = frefList.front();
-
-        if(rockptr)
-            *rockptr = first->rock();
-
-        SPDLOG_TRACE("glk_fileref_iterate({}, {}) => {}", wrap::ptr(fref), wrap::ptr(rockptr), wrap::ptr(first));
-        return TO_FREFID(first);
-    }
-
-    auto it = frefList.cbegin();
-
-    while(it != frefList.cend() && (*it++) != FROM_FREFID(fref));
-
-    if(it == frefList.cend()) {
-        SPDLOG_TRACE("glk_fileref_iterate({}, {}) => {}", wrap::ptr(fref), wrap::ptr(rockptr), wrap::ptr(nullptr));
-        return NULL;
-    }
+    if(next && rockptr)
+        *rockptr = next->rock();
 
-    if(rockptr)
-        *rockptr = (*it)->rock();
+    SPDLOG_TRACE("glk_fileref_iterate({}, {}) => {}", wrap::ptr(fref), wrap::ptr(rockptr), wrap::ptr(TO_FREFID(next)));
 
-    SPDLOG_TRACE("glk_fileref_iterate({}, {}) => {}", wrap::ptr(fref), wrap::ptr(rockptr), wrap::ptr(*it));
-    return TO_FREFID(*it);
+    return TO_FREFID(next);
 }
 
 glui32 glk_fileref_get_rock(frefid_t fref) {
@@ -1,4 +1,5 @@
 #include <cassert>
+#include <vector>
 
 #include "glk.hpp"
 
@@ -7,22 +8,17 @@
 #include "blorb/chunk.hpp"
 #include "log/log.hpp"
 #include "sound/schannel.hpp"
-#include "thread/taskrequest.hpp"
 
 schanid_t glk_schannel_create(glui32 rock) {
     return glk_schannel_create_ext(rock, Glk::SoundChannel::FullVolume);
 }
 
 schanid_t glk_schannel_create_ext(glui32 rock, glui32 volume) {
-    Glk::SoundChannel* sch;
-
-    Glk::sendTaskToEventThread([&] {sch = new Glk::SoundChannel(volume, rock);});
-
-    return TO_SCHANID(sch);
+    return TO_SCHANID(new Glk::SoundChannel(volume, rock));
 }
 
 void glk_schannel_destroy(schanid_t chan) {
-    Glk::sendTaskToEventThread([&] {delete FROM_SCHANID(chan);});
+    delete FROM_SCHANID(chan);
 }
 
 glui32 glk_schannel_play(schanid_t chan, glui32 snd) {
@@ -30,23 +26,19 @@ glui32 glk_schannel_play(schanid_t chan, glui32 snd) {
 }
 
 glui32 glk_schannel_play_ext(schanid_t chan, glui32 snd, glui32 repeats, glui32 notify) {
-    glui32 res;
-
-    Glk::sendTaskToEventThread([&] {res = ((FROM_SCHANID(chan)->play(snd, repeats, notify)) ? 1 : 0);});
-//     res = ((FROM_SCHANID(chan)->play(snd, repeats, notify)) ? 1 : 0);
-
-    return res;
+    return (FROM_SCHANID(chan)->play(snd, repeats, notify) ? 1 : 0);
 }
 
 glui32 glk_schannel_play_multi(schanid_t* chanarray, glui32 chancount, glui32* sndarray, glui32 soundcount, glui32 notify) {
     assert(chancount == soundcount);
 
-    glui32 count = 0;
+    std::vector<std::pair<Glk::SoundChannel*, glui32>> plays;
+    plays.reserve(chancount);
 
     for(glui32 ii = 0; ii < chancount; ii++)
-        count += glk_schannel_play_ext(chanarray[ii], sndarray[ii], 1, notify);
+        plays.emplace_back(FROM_SCHANID(chanarray[ii]), sndarray[ii]);
 
-    return count;
+    return Glk::SoundChannel::playMulti(plays, notify);
 }
 
 void glk_schannel_stop(schanid_t chan) {
@@ -69,42 +61,22 @@ void glk_schannel_set_volume_ext(schanid_t chan, glui32 vol, glui32 duration, gl
     FROM_SCHANID(chan)->setVolume(vol, duration, notify);
 }
 
-void glk_sound_load_hint(glui32 snd, glui32 flag) {}
-
-schanid_t glk_schannel_iterate(schanid_t schan, glui32* rockptr) {
-    const auto& schanList = QGlk::getMainWindow().soundChannelList();
-
-    if(schan == NULL) {
-        if(schanList.empty()) {
-            SPDLOG_TRACE("glk_schannel_iterate({}, {}) => {}", wrap::ptr(schan), wrap::ptr(rockptr), (void*)NULL);
-            return NULL;
-        }
+void glk_sound_load_hint(glui32 snd, glui32 flag) {
+    SPDLOG_TRACE("glk_sound_load_hint({}, {})", snd, flag);
 
-        auto first = schanList.front();
-
-        if(rockptr)
-            *rockptr = first->rock();
-
-        SPDLOG_TRACE("glk_schannel_iterate({}, {}) => {}", wrap::ptr(schan), wrap::ptr(rockptr), wrap::ptr(first));
-
-        return TO_SCHANID(first);
-    }
-
-    auto it = schanList.cbegin();
-
-    while(it != schanList.cend() && (*it++) != FROM_SCHANID(schan));
+    QGlk::getMainWindow().prefetcher().hint(Glk::Blorb::ResourceUsage::Sound, snd, flag != 0);
+}
 
-    if(it == schanList.cend()) {
-        SPDLOG_TRACE("glk_schannel_iterate({}, {}) => {}", wrap::ptr(schan), wrap::ptr(rockptr), (void*)NULL);
-        return NULL;
-    }
+schanid_t glk_schannel_iterate(schanid_t schan, glui32* rockptr) {
+    const auto& table = QGlk::getMainWindow().soundChannelTable();
+    auto next = schan == NULL ? table.first() : table.next(FROM_SCHANID(schan));
 
-    if(rockptr)
-        *rockptr = (*it)->rock();
+    if(next && rockptr)
+        *rockptr = next->rock();
 
-    SPDLOG_TRACE("glk_schannel_iterate({}, {}) => {}", wrap::ptr(schan), wrap::ptr(rockptr), wrap::ptr(*it));
+    SPDLOG_TRACE("glk_schannel_iterate({}, {}) => {}", wrap::ptr(schan), wrap::ptr(rockptr), wrap::ptr(TO_SCHANID(next)));
 
-    return TO_SCHANID(*it);
+    return TO_SCHANID(next);
 }
 
 glui32 glk_schannel_get_rock(schanid_t chan) {
@@ -46,39 +46,15 @@ void glk_stream_close(strid_t str, stream_result_t* result) {
 }
 
 strid_t glk_stream_iterate(strid_t str, glui32* rockptr) {
-    const auto& strList = QGlk::getMainWindow().streamList();
+    const auto& table = QGlk::getMainWindow().streamTable();
+    auto next = str == NULL ? table.first() : table.next(FROM_STRID(str));
 
-    if(str == NULL) {
-        if(strList.empty()) {
-            SPDLOG_TRACE("glk_stream_iterate({}, {}) => {}", wrap::ptr(str), wrap::ptr(rockptr), wrap::ptr(strid_t(NULL)));
-            return NULL;
-        }
-
-        auto first = strList.front();
-
-        if(rockptr)
-            *rockptr = first->rock();
-
-        SPDLOG_TRACE("glk_stream_iterate({}, {}) => {}", wrap::ptr(str), wrap::ptr(rockptr), wrap::ptr(first));
-
-        return TO_STRID(first);
-    }
-
-    auto it = strList.cbegin();
+    if(next && rockptr)
+        *rockptr = next->rock();
 
-    while(it != strList.cend() && (*it++) != FROM_STRID(str));
+    SPDLOG_TRACE("glk_stream_iterate({}, {}) => {}", wrap::ptr(str), wrap::ptr(rockptr), wrap::ptr(TO_STRID(next)));
 
-    if(it == strList.cend()) {
-        SPDLOG_TRACE("glk_stream_iterate({}, {}) => {}", wrap::ptr(str), wrap::ptr(rockptr), wrap::ptr(strid_t(NULL)));
-        return NULL;
-    }
-
-    if(rockptr)
-        *rockptr = (*it)->rock();
-
-    SPDLOG_TRACE("glk_stream_iterate({}, {}) => {}", wrap::ptr(str), wrap::ptr(rockptr), wrap::ptr(*it));
-
-    return TO_STRID(*it);
+    return TO_STRID(next);
 }
 
 glui32 glk_stream_get_rock(strid_t str) {
@@ -246,15 +222,27 @@ glui32 glk_get_line_stream_uni(strid_t str, glui32* buf, glui32 len) {
     return count;
 }
 
+namespace {
+    template<bool ReadOnly>
+    std::unique_ptr<std::streambuf> makeMemBuf(Glk::MemoryArea*& area,
+                                               typename Glk::MemBuf<ReadOnly>::char_type* buf, glui32 length,
+                                               bool unicode) {
+        auto membuf = std::make_unique<Glk::RegisteredMemBuf<ReadOnly>>(buf, length, unicode);
+        area = &membuf->area();
+        return membuf;
+    }
+}
+
 strid_t glk_stream_open_memory(char* buf, glui32 buflen, glui32 fmode, glui32 rock) {
     SPDLOG_TRACE("glk_stream_open_memory({}, {}, {}, {})", (void*)buf, buflen, wrap::filemode(fmode), rock);
 
     std::unique_ptr<std::streambuf> streambuf;
+    Glk::MemoryArea* area = nullptr;
     if(buf) {
         if(fmode == filemode_Read)
-            streambuf = std::make_unique<Glk::RegisteredMemBuf<true>>(buf, buflen, false);
+            streambuf = makeMemBuf<true>(area, buf, buflen, false);
         else
-            streambuf = std::make_unique<Glk::RegisteredMemBuf<false>>(buf, buflen, false);
+            streambuf = makeMemBuf<false>(area, buf, buflen, false);
 
         if(fmode == filemode_WriteAppend)
             streambuf->pubseekoff(0, std::ios_base::end);
@@ -262,18 +250,21 @@ strid_t glk_stream_open_memory(char* buf, glui32 buflen, glui32 fmode, glui32 ro
         streambuf = std::make_unique<Glk::NullBuf>();
     }
 
-    return TO_STRID(new Glk::Latin1Stream{nullptr, std::move(streambuf), Glk::Stream::Type::Memory, false, rock});
+    auto str = new Glk::Latin1Stream{std::move(streambuf), Glk::Stream::Type::Memory, false, rock};
+    str->setMemoryArea(area);
+    return TO_STRID(str);
 }
 
 strid_t glk_stream_open_memory_uni(glui32* buf, glui32 buflen, glui32 fmode, glui32 rock) {
     SPDLOG_TRACE("glk_stream_open_memory_uni({}, {}, {}, {})", (void*)buf, buflen, wrap::filemode(fmode), rock);
 
     std::unique_ptr<std::streambuf> streambuf;
+    Glk::MemoryArea* area = nullptr;
     if(buf) {
         if(fmode == filemode_Read)
-            streambuf = std::make_unique<Glk::RegisteredMemBuf<true>>((char*)buf, sizeof(glui32)*buflen, true);
+            streambuf = makeMemBuf<true>(area, (char*)buf, sizeof(glui32)*buflen, true);
         else
-            streambuf = std::make_unique<Glk::RegisteredMemBuf<false>>((char*)buf, sizeof(glui32)*buflen, true);
+            streambuf = makeMemBuf<false>(area, (char*)buf, sizeof(glui32)*buflen, true);
 
         if(fmode == filemode_WriteAppend)
             streambuf->pubseekoff(0, std::ios_base::end);
@@ -281,7 +272,9 @@ strid_t glk_stream_open_memory_uni(glui32* buf, glui32 buflen, glui32 fmode, glu
         streambuf = std::make_unique<Glk::NullBuf>();
     }
 
-    return TO_STRID(new Glk::UnicodeStream{nullptr, std::move(streambuf), Glk::Stream::Type::Memory, false, rock});
+    auto str = new Glk::UnicodeStream{std::move(streambuf), Glk::Stream::Type::Memory, false, rock};
+    str->setMemoryArea(area);
+    return TO_STRID(str);
 }
 
 strid_t glk_stream_open_file(frefid_t fileref, glui32 fmode, glui32 rock) {
@@ -320,7 +313,9 @@ strid_t glk_stream_open_file(frefid_t fileref, glui32 fmode, glui32 rock) {
     if((FROM_FREFID(fileref)->usage() & 0x100) == Glk::FileReference::TextMode)
         textMode = true;
 
-    return TO_STRID(new Glk::Latin1Stream{nullptr, std::move(filebuf), Glk::Stream::Type::File, textMode, rock});
+    auto str = new Glk::Latin1Stream{std::move(filebuf), Glk::Stream::Type::File, textMode, rock};
+    str->setFilePath(FROM_FREFID(fileref)->path());
+    return TO_STRID(str);
 }
 
 strid_t glk_stream_open_file_uni(frefid_t fileref, glui32 fmode, glui32 rock) {
@@ -359,7 +354,9 @@ strid_t glk_stream_open_file_uni(frefid_t fileref, glui32 fmode, glui32 rock) {
     if((FROM_FREFID(fileref)->usage() & 0x100) == Glk::FileReference::TextMode)
         textMode = true;
 
-    return TO_STRID(new Glk::UnicodeStream{nullptr, std::move(filebuf), Glk::Stream::Type::File, textMode, rock});
+    auto str = new Glk::UnicodeStream{std::move(filebuf), Glk::Stream::Type::File, textMode, rock};
+    str->setFilePath(FROM_FREFID(fileref)->path());
+    return TO_STRID(str);
 }
 
 strid_t glk_stream_open_resource(glui32 filenum, glui32 rock) {
@@ -375,7 +372,7 @@ strid_t glk_stream_open_resource(glui32 filenum, glui32 rock) {
 
     std::unique_ptr<std::streambuf> streambuf = std::make_unique<Glk::ChunkBuf>(std::move(chunk));
 
-    return TO_STRID(new Glk::Latin1Stream{nullptr, std::move(streambuf), Glk::Stream::Type::Resource, textMode, rock});
+    return TO_STRID(new Glk::Latin1Stream{std::move(streambuf), Glk::Stream::Type::Resource, textMode, rock});
 }
 
 strid_t glk_stream_open_resource_uni(glui32 filenum, glui32 rock) {
@@ -391,7 +388,7 @@ strid_t glk_stream_open_resource_uni(glui32 filenum, glui32 rock) {
 
     std::unique_ptr<std::streambuf> streambuf = std::make_unique<Glk::ChunkBuf>(std::move(chunk));
 
-    return TO_STRID(new Glk::UnicodeStream{nullptr, std::move(streambuf), Glk::Stream::Type::Resource, textMode, rock});
+    return TO_STRID(new Glk::UnicodeStream{std::move(streambuf), Glk::Stream::Type::Resource, textMode, rock});
 }
 
 void glk_set_hyperlink(glui32 linkval) {
@@ -37,5 +37,8 @@ strid_t glkunix_stream_open_pathname(char* pathname, glui32 textmode, glui32 roc
         return NULL;
     }
 
-    return TO_STRID(new Glk::Latin1Stream{nullptr, std::move(filebuf), Glk::Stream::Type::File, textmode != 0, rock});
+    auto str = new Glk::Latin1Stream{std::move(filebuf), Glk::Stream::Type::File, textmode != 0, rock};
+    std::error_code ec;
+    str->setFilePath(std::filesystem::absolute(pathname, ec));
+    return TO_STRID(str);
 }
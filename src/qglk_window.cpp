@@ -35,7 +35,7 @@ winid_t glk_window_open(winid_t split, glui32 method, glui32 size, glui32 wintyp
             return NULL;
     }
 
-    if(!split && !QGlk::getMainWindow().windowList().empty()) {
+    if(!split && !QGlk::getMainWindow().windowTable().empty()) {
         spdlog::warn("Tried to open another root window");
         SPDLOG_TRACE("glk_window_open({}, {}, {}, {}, {}) => {}", wrap::ptr(split), wrap::splitmethod(method),
                      size, wrap::wintype(wintype), rock, wrap::ptr((winid_t) (nullptr)));
@@ -162,39 +162,15 @@ strid_t glk_window_get_echo_stream(winid_t win) {
 }
 
 winid_t glk_window_iterate(winid_t win, glui32* rockptr) {
-    const auto& winList = QGlk::getMainWindow().windowList();
+    const auto& table = QGlk::getMainWindow().windowTable();
+    auto next = win == NULL ? table.first() : table.next(FROM_WINID(win));
 
-    if(win == NULL) {
-        if(winList.empty()) {
-            SPDLOG_TRACE("glk_window_iterate({}, {}) => {}", wrap::ptr(win), wrap::ptr(rockptr), wrap::ptr(strid_t(NULL)));
-            return NULL;
-        }
-
-        auto first = winList.front();
+    if(next && rockptr)
+        *rockptr = next->rock();
 
-        if(rockptr)
-            *rockptr = first->rock();
+    SPDLOG_TRACE("glk_window_iterate({}, {}) => {}", wrap::ptr(win), wrap::ptr(rockptr), wrap::ptr(TO_WINID(next)));
 
-        SPDLOG_TRACE("glk_window_iterate({}, {}) => {}", wrap::ptr(win), wrap::ptr(rockptr), wrap::ptr(first));
-
-        return TO_WINID(first);
-    }
-
-    auto it = winList.cbegin();
-
-    while(it != winList.cend() && (*it++) != FROM_WINID(win));
-
-    if(it == winList.cend()) {
-        SPDLOG_TRACE("glk_window_iterate({}, {}) => {}", wrap::ptr(win), wrap::ptr(rockptr), wrap::ptr(strid_t(NULL)));
-        return NULL;
-    }
-
-    if(rockptr)
-        *rockptr = (*it)->rock();
-
-    SPDLOG_TRACE("glk_window_iterate({}, {}) => {}", wrap::ptr(win), wrap::ptr(rockptr), wrap::ptr(*it));
-
-    return TO_WINID(*it);
+    return TO_WINID(next);
 }
 
 glui32 glk_window_get_rock(winid_t win) {
@@ -270,22 +246,37 @@ void glk_window_erase_rect(winid_t win, glsi32 left, glsi32 top, glui32 width, g
     FROM_WINID(win)->eraseRect(QRect(left, top, width, height));
 }
 
+namespace {
+    /// Calls fn with each style manager a hint for the given window type applies to.
+    template <typename Fn>
+    void forEachStyleManager(glui32 wintype, Fn fn) {
+        if(wintype == wintype_AllTypes || wintype == Glk::Window::TextBuffer)
+            fn(QGlk::getMainWindow().textBufferStyleManager());
+
+        if(wintype == wintype_AllTypes || wintype == Glk::Window::TextGrid)
+            fn(QGlk::getMainWindow().textGridStyleManager());
+    }
+}
+
 // style related functions use threads because in the future it should be possible to change
 // fonts and colours from QGlk via a menu or something
 void glk_stylehint_set(glui32 wintype, glui32 styl, glui32 hint, glsi32 val) {
-    if(wintype != Glk::Window::TextBuffer)
+    if(!Glk::StyleManager::isValid(styl))
         return;
 
-    QGlk::getMainWindow().textBufferStyleManager()[static_cast<Glk::Style::Type>(styl)].setHint(hint, val);
+    forEachStyleManager(wintype, [styl, hint, val](Glk::StyleManager& styles) {
+        styles[static_cast<Glk::Style::Type>(styl)].setHint(hint, val);
+    });
 }
 
 void glk_stylehint_clear(glui32 wintype, glui32 styl, glui32 hint) {
-    if(wintype != Glk::Window::TextBuffer)
+    if(!Glk::StyleManager::isValid(styl))
         return;
 
-    QGlk::getMainWindow().textBufferStyleManager()[static_cast<Glk::Style::Type>(styl)].setHint(hint,
-                                                                                                QGlk::getMainWindow().defaultStyleManager()[static_cast<Glk::Style::Type>(styl)].getHint(
-                                                                                                    hint));
+    glui32 val = QGlk::getMainWindow().defaultStyleManager()[static_cast<Glk::Style::Type>(styl)].getHint(hint);
+    forEachStyleManager(wintype, [styl, hint, val](Glk::StyleManager& styles) {
+        styles[static_cast<Glk::Style::Type>(styl)].setHint(hint, val);
+    });
 }
 
 glui32 glk_style_distinguish(winid_t win, glui32 styl1, glui32 styl2) {
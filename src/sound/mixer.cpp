@@ -0,0 +1,391 @@
+#include "mixer.hpp"
+
+#include <algorithm>
+
+#include <QAudioDeviceInfo>
+
+#include "qglk.hpp"
+
+#include "log/log.hpp"
+
+Glk::MixerDevice::MixerDevice(Mixer& mixer) : QIODevice{}, mr_Mixer{mixer} {}
+
+qint64 Glk::MixerDevice::readData(char* data, qint64 maxlen) {
+    size_t frames = size_t(maxlen) / SoundSource::FRAME_BYTES;
+    mr_Mixer.render(reinterpret_cast<qint16*>(data), frames);
+
+    return qint64(frames) * SoundSource::FRAME_BYTES;
+}
+
+Glk::Mixer::~Mixer() {
+    if(!m_Started)
+        return;
+
+    QMetaObject::invokeMethod(mp_Device, [this]() { teardownOutput(); }, Qt::BlockingQueuedConnection);
+    m_Thread.quit();
+    m_Thread.wait();
+
+    delete mp_Device;
+}
+
+glui32 Glk::Mixer::createChannel(glui32 volume) {
+    if(!m_Started)
+        start();
+
+    glui32 id = m_NextChannel++;
+    post(Message{Message::Type::Create, id, 0, 0, 0, volume, 0});
+
+    return id;
+}
+
+void Glk::Mixer::destroyChannel(glui32 channel) {
+    post(Message{Message::Type::Destroy, channel});
+}
+
+void Glk::Mixer::play(glui32 channel, glui32 snd, glui32 repeats, glui32 notify) {
+    post(Message{Message::Type::Play, channel, snd, repeats, notify, 0, 0, 0, 0, source(snd)});
+}
+
+void Glk::Mixer::playBatch(const std::vector<BatchEntry>& entries, glui32 notify) {
+    if(entries.empty())
+        return;
+
+    glui32 batch = m_NextBatch++;
+    for(const auto& entry : entries)
+        post(Message{Message::Type::Play, entry.channel, entry.sound, 1, notify, 0, 0, batch, glui32(entries.size()),
+                     source(entry.sound)});
+}
+
+void Glk::Mixer::stop(glui32 channel) {
+    post(Message{Message::Type::Stop, channel});
+}
+
+void Glk::Mixer::pause(glui32 channel) {
+    post(Message{Message::Type::Pause, channel});
+}
+
+void Glk::Mixer::unpause(glui32 channel) {
+    post(Message{Message::Type::Unpause, channel});
+}
+
+void Glk::Mixer::setVolume(glui32 channel, glui32 volume, glui32 duration, glui32 notify) {
+    post(Message{Message::Type::SetVolume, channel, 0, 0, notify, volume, duration});
+}
+
+void Glk::Mixer::post(const Message& msg) {
+    /* the glk thread is the only producer (or the event thread, once the glk thread is gone). The queue only fills up
+     * if the audio thread is stalled, in which case there is nothing better to do than wait */
+    while(!m_Messages.tryPush(Message{msg}))
+        QThread::yieldCurrentThread();
+}
+
+void Glk::Mixer::start() {
+    m_Started = true;
+
+    mp_Device = new MixerDevice{*this};
+    mp_Device->moveToThread(&m_Thread);
+
+    m_Thread.setObjectName("QGlk audio");
+    m_Thread.start(QThread::TimeCriticalPriority);
+
+    QMetaObject::invokeMethod(mp_Device, [this]() { setupOutput(); }, Qt::QueuedConnection);
+}
+
+void Glk::Mixer::setupOutput() {
+    QAudioFormat format = SoundSource::format();
+    QAudioDeviceInfo info = QAudioDeviceInfo::defaultOutputDevice();
+    if(!info.isFormatSupported(format))
+        spdlog::warn("Audio device '{}' does not support 16-bit stereo at {} Hz", info.deviceName(), SoundSource::SAMPLE_RATE);
+
+    mp_Output = new QAudioOutput{info, format};
+    mp_Output->setBufferSize(LATENCY_FRAMES * SoundSource::FRAME_BYTES);
+
+    mp_Device->open(QIODevice::ReadOnly);
+    mp_Output->start(mp_Device);
+
+    SPDLOG_DEBUG("Audio output started on '{}' with a {} byte buffer", info.deviceName(), mp_Output->bufferSize());
+}
+
+void Glk::Mixer::teardownOutput() {
+    if(mp_Output) {
+        mp_Output->stop();
+        delete mp_Output;
+        mp_Output = nullptr;
+    }
+
+    mp_Device->close();
+
+    m_Channels.clear();
+    m_PendingBatches.clear();
+}
+
+void Glk::Mixer::processMessage(const Message& msg) {
+    if(msg.type == Message::Type::Play && msg.batch != 0) {
+        queueBatchPlay(msg);
+        return;
+    }
+
+    /* a batch still waiting for its sounds must not start them over anything done to the channel since */
+    if(msg.type == Message::Type::Play || msg.type == Message::Type::Stop || msg.type == Message::Type::Destroy)
+        cancelBatchPlay(msg.channel);
+
+    if(msg.type == Message::Type::Create) {
+        Channel& ch = m_Channels[msg.channel];
+        ch.gain = ch.targetGain = float(msg.volume) / SoundChannel::FullVolume;
+        return;
+    }
+
+    auto it = m_Channels.find(msg.channel);
+    if(it == m_Channels.end())
+        return;
+
+    Channel& ch = it->second;
+    switch(msg.type) {
+        case Message::Type::Destroy:
+            m_Channels.erase(it);
+            break;
+
+        case Message::Type::Play:
+            startChannel(ch, msg, msg.source);
+            break;
+
+        case Message::Type::Stop:
+            ch.source.reset();
+            break;
+
+        case Message::Type::Pause:
+            ch.paused = true;
+            break;
+
+        case Message::Type::Unpause:
+            ch.paused = false;
+            break;
+
+        case Message::Type::SetVolume:
+            ch.targetGain = float(msg.volume) / SoundChannel::FullVolume;
+            ch.volumeNotify = msg.notify;
+            ch.rampFrames = size_t(msg.duration) * SoundSource::SAMPLE_RATE / 1000;
+            ch.gainStep = ch.rampFrames ? (ch.targetGain - ch.gain) / float(ch.rampFrames) : 0;
+            if(ch.rampFrames == 0) {
+                ch.rampFrames = 1;
+                advanceRamp(ch, 1);
+            }
+            break;
+
+        case Message::Type::Create:
+            break;
+    }
+}
+
+void Glk::Mixer::cancelBatchPlay(glui32 channel) {
+    for(auto it = m_PendingBatches.begin(); it != m_PendingBatches.end();) {
+        Batch& batch = *it;
+
+        auto play = std::find_if(batch.plays.begin(), batch.plays.end(), [channel](const Message& msg) {
+            return msg.channel == channel;
+        });
+        if(play == batch.plays.end()) {
+            ++it;
+            continue;
+        }
+
+        batch.plays.erase(play);
+        batch.size--;
+
+        if(batch.size == 0)
+            it = m_PendingBatches.erase(it);
+        else
+            ++it;
+    }
+}
+
+void Glk::Mixer::queueBatchPlay(const Message& msg) {
+    /* a later play on the same channel replaces an earlier one still waiting, and whatever the channel was playing
+     * stops now rather than when the batch starts */
+    cancelBatchPlay(msg.channel);
+    if(auto ch = m_Channels.find(msg.channel); ch != m_Channels.end())
+        ch->second.source.reset();
+
+    auto it = std::find_if(m_PendingBatches.begin(), m_PendingBatches.end(), [&msg](const Batch& batch) {
+        return batch.id == msg.batch;
+    });
+    if(it == m_PendingBatches.end())
+        it = m_PendingBatches.insert(m_PendingBatches.end(), Batch{msg.batch, msg.batchSize, {}});
+
+    it->plays.push_back(msg);
+}
+
+void Glk::Mixer::startReadyBatches(size_t frames) {
+    for(auto it = m_PendingBatches.begin(); it != m_PendingBatches.end();) {
+        Batch& batch = *it;
+        if(batch.plays.size() != batch.size) {
+            ++it;
+            continue;
+        }
+
+        bool ready = std::all_of(batch.plays.begin(), batch.plays.end(), [](const Message& play) {
+            return !play.source || play.source->isComplete() || play.source->frames() >= BATCH_READY_FRAMES;
+        });
+        if(!ready && batch.waitedFrames < BATCH_MAX_WAIT_FRAMES) {
+            batch.waitedFrames += frames;
+            ++it;
+            continue;
+        }
+
+        if(!ready)
+            spdlog::warn("Starting sound batch {} before all of its sounds are decoded", batch.id);
+
+        for(size_t ii = 0; ii < batch.plays.size(); ii++) {
+            if(auto ch = m_Channels.find(batch.plays[ii].channel); ch != m_Channels.end()) {
+                startChannel(ch->second, batch.plays[ii], batch.plays[ii].source);
+                ch->second.batch = batch.id;
+            }
+        }
+
+        m_StartedBatches.push_back(batch.id);
+        it = m_PendingBatches.erase(it);
+    }
+}
+
+void Glk::Mixer::reportBatchSkew() {
+    for(glui32 id : m_StartedBatches) {
+        std::uint64_t first = NOT_STARTED, last = 0;
+        size_t count = 0;
+        for(const auto& [chid, ch] : m_Channels) {
+            if(ch.batch != id || ch.startFrame == NOT_STARTED)
+                continue;
+
+            first = std::min(first, ch.startFrame);
+            last = std::max(last, ch.startFrame);
+            count++;
+        }
+
+        if(count == 0)
+            continue;
+
+        m_LastBatchSkew.store(size_t(last - first), std::memory_order_relaxed);
+        SPDLOG_DEBUG("Started sound batch {} on {} channels with a skew of {} frames", id, count, last - first);
+    }
+
+    m_StartedBatches.clear();
+}
+
+void Glk::Mixer::render(qint16* out, size_t frames) {
+    while(auto msg = m_Messages.tryPop())
+        processMessage(*msg);
+
+    startReadyBatches(frames);
+
+    m_MixBuffer.assign(frames * SoundSource::CHANNELS, 0.0f);
+
+    for(auto& [id, ch] : m_Channels)
+        mixChannel(ch, m_MixBuffer.data(), frames);
+
+    reportBatchSkew();
+    m_FramesRendered += frames;
+
+    std::transform(m_MixBuffer.begin(), m_MixBuffer.end(), out, [](float sample) {
+        return qint16(std::clamp(sample, -32768.0f, 32767.0f));
+    });
+}
+
+void Glk::Mixer::mixChannel(Channel& ch, float* out, size_t frames) {
+    size_t done = 0;
+
+    while(done < frames && ch.source && !ch.paused) {
+        if(!ch.segment || ch.offset == ch.segment->frames()) {
+            /* segments are only ever appended, so the channel walks them in order and never looks one up */
+            if(auto next = nextSegment(ch)) {
+                ch.segment = next;
+                ch.offset = 0;
+                continue;
+            }
+
+            /* still decoding, we pick up where we left off on the next pass */
+            if(!ch.source->isComplete())
+                break;
+
+            /* the last segment may have been published just before the source completed */
+            if(nextSegment(ch))
+                continue;
+
+            if(ch.source->frames() == 0 || (ch.repeats != REPEAT_FOREVER && --ch.repeats == 0)) {
+                finishChannel(ch);
+                break;
+            }
+
+            ch.segment = nullptr;
+            continue;
+        }
+
+        if(ch.startFrame == NOT_STARTED)
+            ch.startFrame = m_FramesRendered + done;
+
+        size_t count = std::min(ch.segment->frames() - ch.offset, frames - done);
+        const qint16* in = ch.segment->samples() + ch.offset * SoundSource::CHANNELS;
+        float* dst = out + done * SoundSource::CHANNELS;
+
+        if(ch.rampFrames == 0) {
+            for(size_t ii = 0; ii < count * SoundSource::CHANNELS; ii++)
+                dst[ii] += in[ii] * ch.gain;
+        } else {
+            for(size_t ii = 0; ii < count; ii++) {
+                advanceRamp(ch, 1);
+                for(int jj = 0; jj < SoundSource::CHANNELS; jj++)
+                    dst[ii * SoundSource::CHANNELS + jj] += in[ii * SoundSource::CHANNELS + jj] * ch.gain;
+            }
+        }
+
+        ch.offset += count;
+        done += count;
+    }
+
+    /* fades carry on in real time whether or not anything is playing */
+    advanceRamp(ch, frames - done);
+}
+
+const Glk::SoundSource::Segment* Glk::Mixer::nextSegment(const Channel& ch) {
+    return ch.segment ? ch.segment->next.load(std::memory_order_acquire) : ch.source->firstSegment();
+}
+
+void Glk::Mixer::advanceRamp(Channel& ch, size_t frames) {
+    if(ch.rampFrames == 0 || frames == 0)
+        return;
+
+    size_t count = std::min(frames, ch.rampFrames);
+    ch.gain += ch.gainStep * float(count);
+    ch.rampFrames -= count;
+
+    if(ch.rampFrames == 0) {
+        ch.gain = ch.targetGain;
+
+        if(ch.volumeNotify != 0)
+            QGlk::getMainWindow().eventQueue().push(event_t{evtype_VolumeNotify, NULL, 0, ch.volumeNotify});
+    }
+}
+
+void Glk::Mixer::startChannel(Channel& ch, const Message& msg, std::shared_ptr<SoundSource> src) {
+    ch.source = std::move(src);
+    ch.segment = nullptr;
+    ch.offset = 0;
+    ch.sound = msg.sound;
+    ch.repeats = msg.repeats;
+    ch.notify = msg.notify;
+    ch.batch = 0;
+    ch.startFrame = NOT_STARTED;
+}
+
+void Glk::Mixer::finishChannel(Channel& ch) {
+    ch.source.reset();
+
+    if(ch.notify != 0)
+        QGlk::getMainWindow().eventQueue().push(event_t{evtype_SoundNotify, NULL, ch.sound, ch.notify});
+}
+
+std::shared_ptr<Glk::SoundSource> Glk::Mixer::source(glui32 snd) {
+    auto src = m_SoundCache.get(snd);
+    if(!src)
+        spdlog::warn("Failed to load sound {}", snd);
+
+    return src;
+}
@@ -0,0 +1,176 @@
+#ifndef SOUND_MIXER_HPP
+#define SOUND_MIXER_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <QAudioOutput>
+#include <QIODevice>
+#include <QThread>
+
+#include "glk.hpp"
+
+#include "soundcache.hpp"
+#include "soundsource.hpp"
+#include "spscqueue.hpp"
+
+namespace Glk {
+    class Mixer;
+
+    /// Pull-mode device the audio output reads the mix from.
+    class MixerDevice : public QIODevice {
+            Q_OBJECT
+        public:
+            explicit MixerDevice(Mixer& mixer);
+
+            bool isSequential() const override {
+                return true;
+            }
+
+        protected:
+            qint64 readData(char* data, qint64 maxlen) override;
+
+            qint64 writeData(const char* data, qint64 len) override {
+                return -1;
+            }
+
+        private:
+            Mixer& mr_Mixer;
+    };
+
+    /// Plays every sound channel through a single audio output driven from its own thread.
+    ///   The glk thread never waits on the audio thread: channel operations are posted as messages, which the audio
+    ///   thread picks up at the start of each mix pass. Plays carry their sound source, looked up in the sound cache
+    ///   before posting, so the audio thread never loads or decodes anything itself. Sounds loop sample-accurately and
+    ///   volume changes are ramped per frame. SoundNotify and VolumeNotify events are pushed straight to the event
+    ///   queue.
+    class Mixer {
+            Q_DISABLE_COPY(Mixer)
+
+            friend class MixerDevice;
+
+            static constexpr glui32 REPEAT_FOREVER = 0xffffffff;
+            static constexpr int LATENCY_FRAMES = 2048;
+            static constexpr size_t BATCH_READY_FRAMES = SoundSource::SAMPLE_RATE / 2;
+            static constexpr size_t BATCH_MAX_WAIT_FRAMES = 2 * SoundSource::SAMPLE_RATE;
+            static constexpr std::uint64_t NOT_STARTED = ~std::uint64_t{0};
+
+            struct Message {
+                enum class Type {
+                    Create, Destroy, Play, Stop, Pause, Unpause, SetVolume
+                };
+
+                Type type{Type::Stop};
+                glui32 channel{0};
+                glui32 sound{0};
+                glui32 repeats{0};
+                glui32 notify{0};
+                glui32 volume{0};
+                glui32 duration{0};
+                glui32 batch{0}; /* plays sharing a batch id start together once batchSize of them have arrived */
+                glui32 batchSize{0};
+                std::shared_ptr<SoundSource> source; /* for plays */
+            };
+
+            struct Batch {
+                glui32 id;
+                glui32 size;
+                std::vector<Message> plays;
+                size_t waitedFrames{0};
+            };
+
+            struct Channel {
+                std::shared_ptr<SoundSource> source;
+                const SoundSource::Segment* segment{nullptr}; /* the one being played, null before the first */
+                size_t offset{0}; /* in frames, into segment */
+                glui32 sound{0};
+                glui32 repeats{0};
+                glui32 notify{0};
+                bool paused{false};
+                glui32 batch{0};
+                std::uint64_t startFrame{NOT_STARTED};
+
+                float gain{1};
+                float targetGain{1};
+                float gainStep{0};
+                size_t rampFrames{0};
+                glui32 volumeNotify{0};
+            };
+
+        public:
+            struct BatchEntry {
+                glui32 channel;
+                glui32 sound;
+            };
+
+            Mixer() = default;
+            ~Mixer();
+
+            /// Returns the id of the new channel. Channel ids are never reused.
+            glui32 createChannel(glui32 volume);
+            void destroyChannel(glui32 channel);
+
+            void play(glui32 channel, glui32 snd, glui32 repeats, glui32 notify);
+            /// Starts all the given sounds on the same output frame, once every one of them is loaded.
+            void playBatch(const std::vector<BatchEntry>& entries, glui32 notify);
+            void stop(glui32 channel);
+            void pause(glui32 channel);
+            void unpause(glui32 channel);
+            void setVolume(glui32 channel, glui32 volume, glui32 duration, glui32 notify);
+
+            /// Spread in output frames between the first and last channel of the most recently started batch.
+            [[nodiscard]] inline size_t lastBatchSkew() const {
+                return m_LastBatchSkew.load(std::memory_order_relaxed);
+            }
+
+        private:
+            void post(const Message& msg);
+
+            void start();
+
+            // audio thread
+            void setupOutput();
+            void teardownOutput();
+
+            void processMessage(const Message& msg);
+            /// Takes the channel's play out of any batch still waiting to start.
+            void cancelBatchPlay(glui32 channel);
+            void queueBatchPlay(const Message& msg);
+            void startReadyBatches(size_t frames);
+            void reportBatchSkew();
+            void render(qint16* out, size_t frames);
+            void mixChannel(Channel& ch, float* out, size_t frames);
+            [[nodiscard]] static const SoundSource::Segment* nextSegment(const Channel& ch);
+
+            void advanceRamp(Channel& ch, size_t frames);
+            void finishChannel(Channel& ch);
+            void startChannel(Channel& ch, const Message& msg, std::shared_ptr<SoundSource> src);
+
+            // glk thread
+            [[nodiscard]] std::shared_ptr<SoundSource> source(glui32 snd);
+
+
+            SpscQueue<Message, 1024> m_Messages;
+            glui32 m_NextChannel{1};
+            glui32 m_NextBatch{1};
+            bool m_Started{false};
+            std::atomic<size_t> m_LastBatchSkew{0};
+            SoundCache m_SoundCache;
+
+            QThread m_Thread;
+            MixerDevice* mp_Device{nullptr};
+
+            // audio thread
+            QAudioOutput* mp_Output{nullptr};
+            std::unordered_map<glui32, Channel> m_Channels;
+            std::vector<float> m_MixBuffer;
+            std::uint64_t m_FramesRendered{0};
+            std::vector<Batch> m_PendingBatches;
+            std::vector<glui32> m_StartedBatches;
+    };
+}
+
+#endif
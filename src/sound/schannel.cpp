@@ -3,84 +3,69 @@
 #include "qglk.hpp"
 
 #include "log/log.hpp"
+#include "sound/soundsource.hpp"
 
-Glk::SoundRepeater::SoundRepeater(QMediaPlayer& mp) : QObject(), mr_Player(mp), m_NumRepeat(0) {
-    connect(&mr_Player, &QMediaPlayer::stateChanged, this, &Glk::SoundRepeater::mediaPlayerStateChanged);
-}
-
-void Glk::SoundRepeater::mediaPlayerStateChanged(QMediaPlayer::State state) {
-    if(state != QMediaPlayer::StoppedState || mr_Player.mediaStatus() != QMediaPlayer::EndOfMedia)
-        return;
-
-    if(m_NumRepeat == 0)
-        return;
-
-    m_NumRepeat--;
-    mr_Player.play();
-}
-
-Glk::SoundChannel::SoundChannel(glui32 volume_, glui32 rock_) : Object(rock_), m_Player(), m_Repeater(m_Player), m_Chunk(), m_Buffer(), m_Paused(false) {
-    m_Player.setVolume(100 * volume_ / FullVolume);
-
+Glk::SoundChannel::SoundChannel(glui32 volume_, glui32 rock_)
+    : Object(rock_),
+      m_Id{QGlk::getMainWindow().mixer().createChannel(volume_)} {
     QGlk::getMainWindow().dispatch().registerObject(this);
-    QGlk::getMainWindow().soundChannelList().push_back(this);
+    QGlk::getMainWindow().soundChannelTable().insert(this);
 }
 
 Glk::SoundChannel::~SoundChannel() {
-    auto& schList = QGlk::getMainWindow().soundChannelList();
-    if(std::count(schList.begin(), schList.end(), this) == 0) {
-        spdlog::warn("Sound channel {} not found in sound channel list while removing", *this);
-    } else {
-        schList.remove(this);
-        SPDLOG_TRACE("Sound channel {} removed from sound channels list", *this);
-    }
+    QGlk::getMainWindow().mixer().destroyChannel(m_Id);
+
+    if(!QGlk::getMainWindow().soundChannelTable().remove(this))
+        spdlog::warn("Sound channel {} not found in sound channel table while removing", *this);
+    else
+        SPDLOG_TRACE("Sound channel {} removed from sound channel table", *this);
 
     QGlk::getMainWindow().dispatch().unregisterObject(this);
 }
 
-bool Glk::SoundChannel::play(glui32 snd, glui32 repeats, bool notify) { //TODO handle notify
-    m_Player.setMedia(QMediaContent());
-    m_Buffer.close();
+bool Glk::SoundChannel::play(glui32 snd, glui32 repeats, glui32 notify) {
+    QGlk::getMainWindow().prefetcher().recordAccess(Glk::Blorb::ResourceUsage::Sound, snd);
 
-    Glk::Blorb::Chunk newc = Glk::Blorb::loadResource(snd, Glk::Blorb::ResourceUsage::Sound);
-    if(!newc.isValid())
+    if(!SoundSource::exists(snd) || repeats == 0) {
+        stop();
         return false;
+    }
 
-    m_Chunk = std::move(newc);
+    QGlk::getMainWindow().mixer().play(m_Id, snd, repeats, notify);
 
-    m_Buffer.setData(QByteArray::fromRawData(m_Chunk.data(), m_Chunk.length()));
-    m_Buffer.open(QIODevice::ReadOnly);
-    m_Buffer.seek(0);
+    return true;
+}
 
-    m_Player.setMedia(QMediaContent(), &m_Buffer);
+glui32 Glk::SoundChannel::playMulti(const std::vector<std::pair<SoundChannel*, glui32>>& plays, glui32 notify) {
+    std::vector<Glk::Mixer::BatchEntry> batch;
+    batch.reserve(plays.size());
 
-    if(repeats == 0)
-        return false;
+    for(const auto& [sch, snd] : plays) {
+        QGlk::getMainWindow().prefetcher().recordAccess(Glk::Blorb::ResourceUsage::Sound, snd);
 
-    m_Repeater.setRepeats(repeats - 1);
+        if(SoundSource::exists(snd))
+            batch.push_back({sch->id(), snd});
+        else
+            sch->stop();
+    }
 
-    if(!m_Paused)
-        m_Player.play();
+    QGlk::getMainWindow().mixer().playBatch(batch, notify);
 
-    return true;
+    return glui32(batch.size());
 }
 
 void Glk::SoundChannel::pause() {
-    m_Player.pause();
-    m_Paused = true;
+    QGlk::getMainWindow().mixer().pause(m_Id);
 }
 
 void Glk::SoundChannel::unpause() {
-    if(m_Paused)
-        m_Player.play();
-
-    m_Paused = false;
+    QGlk::getMainWindow().mixer().unpause(m_Id);
 }
 
 void Glk::SoundChannel::stop() {
-    m_Player.stop();
+    QGlk::getMainWindow().mixer().stop(m_Id);
 }
 
-void Glk::SoundChannel::setVolume(glui32 volume, glui32 duration, bool notify) { //TODO handle duration and notify
-    m_Player.setVolume(100 * volume / FullVolume);
+void Glk::SoundChannel::setVolume(glui32 volume, glui32 duration, glui32 notify) {
+    QGlk::getMainWindow().mixer().setVolume(m_Id, volume, duration, notify);
 }
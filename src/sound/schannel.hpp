@@ -1,34 +1,15 @@
 #ifndef SCHANNEL_HPP
 #define SCHANNEL_HPP
 
-#include <QBuffer>
-#include <QMediaPlayer>
-#include <QSet>
+#include <utility>
+#include <vector>
 
 #include <fmt/format.h>
 
 #include "glk.hpp"
 
-#include "blorb/chunk.hpp"
-
 namespace Glk {
-    class SoundRepeater : public QObject {
-            Q_OBJECT
-        public:
-            SoundRepeater(QMediaPlayer& mp);
-
-            inline void setRepeats(glui32 nr) {
-                m_NumRepeat = nr;
-            }
-
-        public slots:
-            void mediaPlayerStateChanged(QMediaPlayer::State state);
-
-        private:
-            QMediaPlayer& mr_Player;
-            glui32 m_NumRepeat;
-    };
-
+    /// Glk side of a sound channel. Playback itself happens in the Mixer, which this only posts requests to.
     class SoundChannel : public Object {
         public:
             static const glui32 FullVolume = 0x10000;
@@ -40,20 +21,22 @@ namespace Glk {
                 return Object::Type::SoundChannel;
             }
 
-            bool play(glui32 snd, glui32 repeats, bool notify);
+            /// The mixer's id for this channel.
+            [[nodiscard]] inline glui32 id() const {
+                return m_Id;
+            }
+
+            bool play(glui32 snd, glui32 repeats, glui32 notify);
+            /// Starts a sound on each of the channels at the same time. Returns the number of sounds started.
+            static glui32 playMulti(const std::vector<std::pair<SoundChannel*, glui32>>& plays, glui32 notify);
             void pause();
             void unpause();
             void stop();
 
-            void setVolume(glui32 volume, glui32 duration = 0, bool notify = false);
+            void setVolume(glui32 volume, glui32 duration = 0, glui32 notify = 0);
 
         private:
-            QMediaPlayer m_Player;
-            SoundRepeater m_Repeater;
-            Glk::Blorb::Chunk m_Chunk;
-            QBuffer m_Buffer;
-
-            bool m_Paused;
+            glui32 m_Id;
     };
 }
 
@@ -61,6 +44,9 @@ inline schanid_t TO_SCHANID(Glk::SoundChannel* sch) {
     return reinterpret_cast<schanid_t>(sch);
 }
 inline Glk::SoundChannel* FROM_SCHANID(schanid_t sch) {
+    if(sch && Glk::validatingHandles())
+        Glk::validateHandle(sch, Glk::Object::SoundChannel);
+
     return reinterpret_cast<Glk::SoundChannel*>(sch);
 }
 
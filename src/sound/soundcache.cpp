@@ -0,0 +1,241 @@
+#include "soundcache.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#include <QByteArrayList>
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QRunnable>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include <fmt/format.h>
+
+#include "blorb/chunk.hpp"
+#include "log/log.hpp"
+
+namespace {
+    class PcmWriteTask : public QRunnable {
+        public:
+            PcmWriteTask(QString path, QByteArrayList pcm, QString root, size_t budget)
+                : m_Path{std::move(path)}, m_Pcm{std::move(pcm)}, m_Root{std::move(root)}, m_Budget{budget} {}
+
+            void run() override {
+                QDir{}.mkpath(QFileInfo{m_Path}.path());
+
+                QSaveFile file{m_Path};
+                bool written = file.open(QIODevice::WriteOnly);
+                for(const QByteArray& segment : m_Pcm)
+                    written = written && file.write(segment) == segment.size();
+
+                if(!written || !file.commit())
+                    spdlog::warn("Failed to write decoded sound to {}: {}", m_Path, file.errorString());
+
+                trim();
+            }
+
+        private:
+            /* removes the files used longest ago until the whole cache fits the budget */
+            void trim() {
+                std::vector<QFileInfo> files;
+                qint64 total = 0;
+
+                QDirIterator it{m_Root, {"*.pcm"}, QDir::Files, QDirIterator::Subdirectories};
+                while(it.hasNext()) {
+                    it.next();
+                    files.push_back(it.fileInfo());
+                    total += files.back().size();
+                }
+
+                if(total <= qint64(m_Budget))
+                    return;
+
+                std::sort(files.begin(), files.end(), [](const QFileInfo& a, const QFileInfo& b) {
+                    return a.lastModified() < b.lastModified();
+                });
+
+                for(const QFileInfo& info : files) {
+                    if(total <= qint64(m_Budget))
+                        break;
+
+                    /* files still mapped by a source stay readable after removal */
+                    if(QFile::remove(info.filePath()))
+                        total -= info.size();
+                }
+            }
+
+
+            QString m_Path;
+            QByteArrayList m_Pcm;
+            QString m_Root;
+            size_t m_Budget;
+    };
+
+    /* the disk cache evicts the files used longest ago first, so every use marks its file as recent */
+    class PcmTouchTask : public QRunnable {
+        public:
+            explicit PcmTouchTask(QString path) : m_Path{std::move(path)} {}
+
+            void run() override {
+                QFile file{m_Path};
+                if(file.open(QIODevice::ReadOnly))
+                    file.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+            }
+
+        private:
+            QString m_Path;
+    };
+}
+
+Glk::SoundCache::SoundCache() : m_Budget{DEFAULT_BUDGET}, m_DiskBudget{DEFAULT_DISK_BUDGET} {
+    bool ok;
+    int budget = qEnvironmentVariableIntValue("QGLK_SOUND_CACHE_MB", &ok);
+    if(ok && budget >= 0)
+        m_Budget = size_t(budget) * 1024 * 1024;
+
+    int diskBudget = qEnvironmentVariableIntValue("QGLK_SOUND_DISK_CACHE_MB", &ok);
+    if(ok && diskBudget >= 0)
+        m_DiskBudget = size_t(diskBudget) * 1024 * 1024;
+
+    m_WritePool.setMaxThreadCount(1);
+}
+
+Glk::SoundCache::~SoundCache() {
+    /* sources still decoding are abandoned along with the thread */
+    if(mp_DecodeContext) {
+        m_DecodeThread.quit();
+        m_DecodeThread.wait();
+        delete mp_DecodeContext;
+    }
+
+    clear();
+}
+
+std::shared_ptr<Glk::SoundSource> Glk::SoundCache::get(glui32 snd) {
+    QMutexLocker ml{&m_Mutex};
+
+    if(auto it = m_Index.find(snd); it != m_Index.end()) {
+        m_Hits++;
+        m_Entries.splice(m_Entries.begin(), m_Entries, it->second);
+        return it->second->source;
+    }
+
+    m_Misses++;
+
+    QString path = cachePath(snd);
+    auto source = SoundSource::load(snd, path);
+    if(!source)
+        return nullptr;
+
+    if(source->isFromDiskCache())
+        m_WritePool.start(new PcmTouchTask{path});
+
+    if(!source->isComplete()) {
+        if(!mp_DecodeContext) {
+            mp_DecodeContext = new QObject;
+            mp_DecodeContext->moveToThread(&m_DecodeThread);
+            m_DecodeThread.setObjectName("QGlk sound decoder");
+            m_DecodeThread.start();
+        }
+
+        source->setCompletionHandler([this](SoundSource& src) {
+            QMutexLocker ml{&m_Mutex};
+
+            if(src.hasFailed()) {
+                forget(src);
+                return;
+            }
+
+            persist(src);
+            evict();
+        });
+        source->decode(mp_DecodeContext);
+    }
+
+    m_Entries.push_front(Entry{snd, source});
+    m_Index[snd] = m_Entries.begin();
+    evict();
+
+    SPDLOG_DEBUG("Sound cache miss for {} ({} hits, {} misses)", snd, m_Hits, m_Misses);
+
+    return source;
+}
+
+void Glk::SoundCache::clear() {
+    m_WritePool.waitForDone();
+
+    QMutexLocker ml{&m_Mutex};
+    m_Index.clear();
+    m_Entries.clear();
+}
+
+QString Glk::SoundCache::cachePath(glui32 snd) {
+    if(!m_CacheDirResolved) {
+        m_CacheDirResolved = true;
+
+        QString base = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+        giblorb_map_t* map = giblorb_get_resource_map();
+        if(!base.isEmpty() && map) {
+            /* the output format is part of the path so changing it cannot pick up stale samples */
+            m_CacheRoot = base + "/sounds/";
+            m_CacheDir = m_CacheRoot + QString::fromStdString(fmt::format("{:016x}/pcm{}x{}/",
+                                                                          Glk::Blorb::indexFingerprint(map),
+                                                                          SoundSource::SAMPLE_RATE,
+                                                                          SoundSource::CHANNELS));
+        }
+    }
+
+    if(m_CacheDir.isEmpty())
+        return {};
+
+    return m_CacheDir + QString::number(snd) + ".pcm";
+}
+
+void Glk::SoundCache::evict() {
+    size_t total = 0;
+    for(const auto& entry : m_Entries)
+        total += entry.source->sizeInBytes();
+
+    /* sources still playing or decoding cannot be given back, so they are skipped even if they are the oldest */
+    for(auto it = m_Entries.end(); total > m_Budget && it != m_Entries.begin();) {
+        --it;
+        if(it->source.use_count() > 1 || !it->source->isComplete())
+            continue;
+
+        total -= it->source->sizeInBytes();
+        SPDLOG_DEBUG("Evicting sound {} from the sound cache", it->sound);
+
+        m_Index.erase(it->sound);
+        it = m_Entries.erase(it);
+    }
+}
+
+void Glk::SoundCache::forget(const SoundSource& source) {
+    /* a file written earlier may be what went wrong, so it goes too; nothing is written for this source now */
+    if(QString path = cachePath(source.sound()); !path.isEmpty())
+        QFile::remove(path);
+
+    /* erasing the entry may drop the last reference to the source, so this comes last */
+    if(auto it = m_Index.find(source.sound()); it != m_Index.end() && it->second->source.get() == &source) {
+        auto entry = it->second;
+        m_Index.erase(it);
+        m_Entries.erase(entry);
+    }
+}
+
+void Glk::SoundCache::persist(const SoundSource& source) {
+    QString path = cachePath(source.sound());
+    if(path.isEmpty() || source.frames() == 0 || source.frames() > MAX_PERSISTED_FRAMES)
+        return;
+
+    /* the samples are final by now, so handing the task shallow copies is safe */
+    QByteArrayList pcm;
+    for(auto seg = source.firstSegment(); seg; seg = seg->next.load(std::memory_order_acquire))
+        pcm.append(seg->pcm);
+
+    m_WritePool.start(new PcmWriteTask{path, std::move(pcm), m_CacheRoot, m_DiskBudget});
+}
@@ -0,0 +1,76 @@
+#ifndef SOUND_SOUNDCACHE_HPP
+#define SOUND_SOUNDCACHE_HPP
+
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+#include <QMutex>
+#include <QString>
+#include <QThread>
+#include <QThreadPool>
+
+#include "glk.hpp"
+
+#include "soundsource.hpp"
+
+namespace Glk {
+    /// Least recently used cache of sound sources, shared by every channel.
+    ///   Decoded samples are kept in memory up to a budget (QGLK_SOUND_CACHE_MB, 64 MiB by default). Short sounds are
+    ///   also written to the user cache directory once decoded, so later sessions can map them instead of decoding.
+    ///   The files on disk are kept under a budget of their own (QGLK_SOUND_DISK_CACHE_MB, 512 MiB by default),
+    ///   shared by every game. Sounds that fail to decode are kept in neither. Sounds are looked up on the glk thread and
+    ///   decoded on a thread of the cache's own, so the audio thread only ever gets sources it can play straight away.
+    class SoundCache {
+            Q_DISABLE_COPY(SoundCache)
+
+            static constexpr size_t DEFAULT_BUDGET = 64 * 1024 * 1024;
+            static constexpr size_t DEFAULT_DISK_BUDGET = 512 * 1024 * 1024;
+            static constexpr size_t MAX_PERSISTED_FRAMES = 10 * SoundSource::SAMPLE_RATE;
+
+            struct Entry {
+                glui32 sound;
+                std::shared_ptr<SoundSource> source;
+            };
+
+        public:
+            SoundCache();
+            ~SoundCache();
+
+            /// Returns the source for the given sound, loading it if needed. Sounds that have to be decoded are
+            ///   returned straight away and filled in as decoding goes. Returns nullptr if it does not exist.
+            [[nodiscard]] std::shared_ptr<SoundSource> get(glui32 snd);
+
+            void clear();
+
+        private:
+            [[nodiscard]] QString cachePath(glui32 snd);
+
+            void evict();
+
+            /// Drops a source whose decoding failed, along with any file left for it on disk.
+            void forget(const SoundSource& source);
+
+            void persist(const SoundSource& source);
+
+
+            QMutex m_Mutex; /* decoding finishes on the decoding thread */
+            size_t m_Budget;
+            size_t m_DiskBudget;
+            std::list<Entry> m_Entries; /* most recently used first */
+            std::unordered_map<glui32, std::list<Entry>::iterator> m_Index;
+
+            QString m_CacheRoot; /* shared by every game, the disk budget covers all of it */
+            QString m_CacheDir;
+            bool m_CacheDirResolved{false};
+
+            size_t m_Hits{0};
+            size_t m_Misses{0};
+
+            QThreadPool m_WritePool;
+            QThread m_DecodeThread;
+            QObject* mp_DecodeContext{nullptr};
+    };
+}
+
+#endif
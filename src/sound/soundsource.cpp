@@ -0,0 +1,164 @@
+#include "soundsource.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include <QtEndian>
+
+#include "qglk.hpp"
+
+#include "log/log.hpp"
+
+namespace {
+    constexpr int WAV_HEADER_SIZE = 44;
+}
+
+QAudioFormat Glk::SoundSource::format() {
+    QAudioFormat fmt;
+    fmt.setSampleRate(SAMPLE_RATE);
+    fmt.setChannelCount(CHANNELS);
+    fmt.setSampleSize(16);
+    fmt.setSampleType(QAudioFormat::SignedInt);
+    fmt.setByteOrder(QAudioFormat::LittleEndian);
+    fmt.setCodec("audio/pcm");
+
+    return fmt;
+}
+
+bool Glk::SoundSource::exists(glui32 snd) {
+    if(!QGlk::getMainWindow().resourcePack().sound(snd).isEmpty())
+        return true;
+
+    giblorb_map_t* map = giblorb_get_resource_map();
+    giblorb_result_t res;
+    return map && giblorb_load_resource(map, giblorb_method_DontLoad, &res, giblorb_ID_Snd, snd) == giblorb_err_None;
+}
+
+std::shared_ptr<Glk::SoundSource> Glk::SoundSource::load(glui32 snd, const QString& cachePath) {
+    auto source = std::make_shared<SoundSource>(snd);
+
+    if(source->usePackedSound(QGlk::getMainWindow().resourcePack().sound(snd)))
+        return source;
+
+    if(!cachePath.isEmpty() && source->useCachedSound(cachePath))
+        return source;
+
+    source->m_Chunk = Glk::Blorb::loadResource(snd, Glk::Blorb::ResourceUsage::Sound);
+    if(!source->m_Chunk.isValid())
+        return nullptr;
+
+    return source;
+}
+
+Glk::SoundSource::SoundSource(glui32 snd) : m_Sound{snd} {}
+
+Glk::SoundSource::~SoundSource() {
+    for(Segment* seg = m_First.load(std::memory_order_acquire); seg;)
+        delete std::exchange(seg, seg->next.load(std::memory_order_acquire));
+}
+
+bool Glk::SoundSource::useCachedSound(const QString& path) {
+    auto file = std::make_unique<QFile>(path);
+    if(!file->open(QIODevice::ReadOnly) || file->size() == 0 || file->size() % FRAME_BYTES != 0)
+        return false;
+
+    const uchar* data = file->map(0, file->size());
+    if(!data)
+        return false;
+
+    m_Mapped = true;
+    append(QByteArray::fromRawData(reinterpret_cast<const char*>(data), int(file->size())));
+    m_Complete = true;
+
+    mp_CacheFile = std::move(file);
+    return true;
+}
+
+bool Glk::SoundSource::usePackedSound(const QByteArray& wav) {
+    /* packs store canonical 44 byte WAV headers in exactly our format, so the samples can be used where they are */
+    if(wav.size() < WAV_HEADER_SIZE || std::memcmp(wav.constData(), "RIFF", 4) != 0 ||
+       std::memcmp(wav.constData() + 36, "data", 4) != 0)
+        return false;
+
+    const auto* header = reinterpret_cast<const uchar*>(wav.constData());
+    if(qFromLittleEndian<quint16>(header + 22) != CHANNELS || qFromLittleEndian<quint32>(header + 24) != SAMPLE_RATE ||
+       qFromLittleEndian<quint16>(header + 34) != 16)
+        return false;
+
+    int length = std::min<int>(qFromLittleEndian<quint32>(header + 40), wav.size() - WAV_HEADER_SIZE);
+    m_Mapped = true;
+    append(QByteArray::fromRawData(wav.constData() + WAV_HEADER_SIZE, length - length % FRAME_BYTES));
+    m_Complete = true;
+    return true;
+}
+
+void Glk::SoundSource::decode(QObject* context) {
+    mp_Self = shared_from_this();
+    QMetaObject::invokeMethod(context, [this]() { startDecoding(); }, Qt::QueuedConnection);
+}
+
+void Glk::SoundSource::startDecoding() {
+    mp_Decoder = std::make_unique<QAudioDecoder>();
+    mp_Decoder->setAudioFormat(format());
+
+    /* the input belongs to the decoder so that it outlives it however the decoder ends up being deleted */
+    auto input = new QBuffer{mp_Decoder.get()};
+    input->setData(QByteArray::fromRawData(m_Chunk.data(), int(m_Chunk.length())));
+    input->open(QIODevice::ReadOnly);
+    mp_Decoder->setSourceDevice(input);
+
+    QObject::connect(mp_Decoder.get(), &QAudioDecoder::bufferReady, [this]() {
+        QAudioBuffer buf = mp_Decoder->read();
+        append(QByteArray{static_cast<const char*>(buf.constData()), buf.byteCount()});
+    });
+    QObject::connect(mp_Decoder.get(), &QAudioDecoder::finished, [this]() {
+        finishDecoding();
+    });
+    QObject::connect(mp_Decoder.get(), QOverload<QAudioDecoder::Error>::of(&QAudioDecoder::error), [this]() {
+        spdlog::warn("Failed to decode sound {}: {}", m_Sound, mp_Decoder->errorString());
+        m_Failed = true;
+        finishDecoding();
+    });
+
+    mp_Decoder->start();
+}
+
+void Glk::SoundSource::append(QByteArray pcm) {
+    pcm.chop(pcm.size() % FRAME_BYTES);
+    if(pcm.isEmpty())
+        return;
+
+    auto seg = new Segment{std::move(pcm)};
+    size_t frames = seg->frames();
+
+    /* the samples are written before the segment is linked in, and the frame count only grows after that */
+    if(mp_Last)
+        mp_Last->next.store(seg, std::memory_order_release);
+    else
+        m_First.store(seg, std::memory_order_release);
+
+    mp_Last = seg;
+    m_Frames.store(m_Frames.load(std::memory_order_relaxed) + frames, std::memory_order_release);
+}
+
+void Glk::SoundSource::finishDecoding() {
+    /* we are inside one of the decoder's signals, so it is let go of from the event loop together with the chunk */
+    if(!mp_Decoder)
+        return;
+
+    /* the handler may well drop every other reference to us, so we hold on to ourselves until we are done */
+    std::shared_ptr<SoundSource> self = std::move(mp_Self);
+
+    QAudioDecoder* decoder = mp_Decoder.release();
+    decoder->disconnect();
+    QObject::connect(decoder, &QObject::destroyed, [chunk = std::move(m_Chunk)]() {});
+    decoder->deleteLater();
+
+    m_Complete = true;
+
+    SPDLOG_DEBUG("Decoded sound {} ({} frames)", m_Sound, frames());
+
+    if(auto handler = std::move(m_CompletionHandler))
+        handler(*this);
+}
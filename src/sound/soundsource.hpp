@@ -0,0 +1,135 @@
+#ifndef SOUND_SOUNDSOURCE_HPP
+#define SOUND_SOUNDSOURCE_HPP
+
+#include <atomic>
+#include <functional>
+#include <memory>
+
+#include <QAudioDecoder>
+#include <QAudioFormat>
+#include <QBuffer>
+#include <QByteArray>
+#include <QFile>
+
+#include "glk.hpp"
+
+#include "blorb/chunk.hpp"
+
+namespace Glk {
+    /// PCM data for one sound resource, in the mixer's output format.
+    ///   Sounds from a resource pack or the on-disk sound cache are used in place. Anything else is decoded
+    ///   incrementally on the thread given to decode(), so a source can be played while it is still being decoded.
+    ///   Decoded samples are appended in segments that never change once published, which is what lets the audio
+    ///   thread read them without taking a lock.
+    class SoundSource : public std::enable_shared_from_this<SoundSource> {
+            Q_DISABLE_COPY(SoundSource)
+        public:
+            static constexpr int SAMPLE_RATE = 44100;
+            static constexpr int CHANNELS = 2;
+            static constexpr int FRAME_BYTES = CHANNELS * sizeof(qint16);
+
+            struct Segment {
+                QByteArray pcm; /* whole frames */
+                std::atomic<Segment*> next{nullptr};
+
+                [[nodiscard]] inline const qint16* samples() const {
+                    return reinterpret_cast<const qint16*>(pcm.constData());
+                }
+
+                [[nodiscard]] inline size_t frames() const {
+                    return size_t(pcm.size()) / FRAME_BYTES;
+                }
+            };
+
+            [[nodiscard]] static QAudioFormat format();
+
+            /// Whether the sound exists at all. Safe to call from any thread.
+            [[nodiscard]] static bool exists(glui32 snd);
+
+            /// Loads the given sound, preferring previously decoded samples at cachePath if there are any. Sounds that
+            ///   are not complete yet still have to be decoded. Returns nullptr if the sound does not exist.
+            [[nodiscard]] static std::shared_ptr<SoundSource> load(glui32 snd, const QString& cachePath = {});
+
+            explicit SoundSource(glui32 snd);
+
+            ~SoundSource();
+
+            [[nodiscard]] inline glui32 sound() const {
+                return m_Sound;
+            }
+
+            /// The samples in the order they play. Segments are only ever appended, so a reader holding one can always
+            ///   move on to its next once that is published.
+            [[nodiscard]] inline const Segment* firstSegment() const {
+                return m_First.load(std::memory_order_acquire);
+            }
+
+            /// Number of frames available so far.
+            [[nodiscard]] inline size_t frames() const {
+                return m_Frames.load(std::memory_order_acquire);
+            }
+
+            /// Whether frames() is final. Every segment is published by the time this is true.
+            [[nodiscard]] inline bool isComplete() const {
+                return m_Complete.load(std::memory_order_acquire);
+            }
+
+            /// Whether decoding stopped on an error, leaving only the frames decoded up to it.
+            [[nodiscard]] inline bool hasFailed() const {
+                return m_Failed;
+            }
+
+            /// Whether the samples had to be decoded here, as opposed to being mapped from a file.
+            [[nodiscard]] inline bool wasDecoded() const {
+                return !m_Mapped;
+            }
+
+            /// Whether the samples are mapped from a file in the on-disk sound cache.
+            [[nodiscard]] inline bool isFromDiskCache() const {
+                return bool(mp_CacheFile);
+            }
+
+            /// Heap memory held by the samples. Mapped samples cost nothing.
+            [[nodiscard]] inline size_t sizeInBytes() const {
+                return wasDecoded() ? frames() * FRAME_BYTES : 0;
+            }
+
+            /// Called on the decoding thread once decoding finishes, successfully or not. Never called for sources that
+            ///   did not need decoding. Has to be set before decode().
+            inline void setCompletionHandler(std::function<void(SoundSource&)> handler) {
+                m_CompletionHandler = std::move(handler);
+            }
+
+            /// Starts decoding on the thread context lives in, which has to run an event loop. The source keeps
+            ///   itself alive until it is done.
+            void decode(QObject* context);
+
+        private:
+            bool useCachedSound(const QString& path);
+
+            bool usePackedSound(const QByteArray& wav);
+
+            void startDecoding();
+
+            /// Publishes the samples as the next segment. Only ever called from one thread at a time.
+            void append(QByteArray pcm);
+
+            void finishDecoding();
+
+            glui32 m_Sound;
+            std::atomic<Segment*> m_First{nullptr};
+            Segment* mp_Last{nullptr};
+            std::atomic<size_t> m_Frames{0};
+            std::atomic_bool m_Complete{false};
+            bool m_Mapped{false};
+            bool m_Failed{false};
+            std::unique_ptr<QFile> mp_CacheFile;
+            std::function<void(SoundSource&)> m_CompletionHandler;
+
+            Glk::Blorb::Chunk m_Chunk;
+            std::unique_ptr<QAudioDecoder> mp_Decoder;
+            std::shared_ptr<SoundSource> mp_Self; /* while decoding */
+    };
+}
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef SOUND_SPSCQUEUE_HPP
+#define SOUND_SPSCQUEUE_HPP
+
+#include <array>
+#include <atomic>
+#include <optional>
+
+namespace Glk {
+    /// Bounded wait-free queue between exactly one producer thread and one consumer thread.
+    template <typename T, size_t Capacity>
+    class SpscQueue {
+            static_assert((Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+
+        public:
+            /// Returns false without blocking if the queue is full.
+            [[nodiscard]] bool tryPush(T&& value) {
+                size_t tail = m_Tail.load(std::memory_order_relaxed);
+                if(tail - m_Head.load(std::memory_order_acquire) == Capacity)
+                    return false;
+
+                m_Slots[tail & (Capacity - 1)] = std::move(value);
+                m_Tail.store(tail + 1, std::memory_order_release);
+                return true;
+            }
+
+            [[nodiscard]] std::optional<T> tryPop() {
+                size_t head = m_Head.load(std::memory_order_relaxed);
+                if(head == m_Tail.load(std::memory_order_acquire))
+                    return std::nullopt;
+
+                std::optional<T> value{std::move(m_Slots[head & (Capacity - 1)])};
+                m_Head.store(head + 1, std::memory_order_release);
+                return value;
+            }
+
+        private:
+            std::array<T, Capacity> m_Slots{};
+
+            /* kept on separate cache lines so the two threads do not keep stealing them from each other */
+            alignas(64) std::atomic<size_t> m_Head{0};
+            alignas(64) std::atomic<size_t> m_Tail{0};
+    };
+}
+
+#endif
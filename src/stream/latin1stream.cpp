@@ -5,8 +5,8 @@
 
 #include <buffer/small_buffer.hpp>
 
-Glk::Latin1Stream::Latin1Stream(QObject* parent_, std::unique_ptr<std::streambuf> buf_, Type type_, bool text_, glui32 rock_)
-        : Stream(parent_, std::move(buf_), type_, text_, false, rock_) {}
+Glk::Latin1Stream::Latin1Stream(std::unique_ptr<std::streambuf> buf_, Type type_, bool text_, glui32 rock_)
+        : Stream(std::move(buf_), type_, text_, false, rock_) {}
 
 Glk::Latin1Stream::~Latin1Stream() = default;
 
@@ -5,9 +5,8 @@
 
 namespace Glk {
     class Latin1Stream final : public Stream {
-            Q_OBJECT
         public:
-            Latin1Stream(QObject* parent_, std::unique_ptr<std::streambuf> buf_, Type type_, bool text_, glui32 rock_);
+            Latin1Stream(std::unique_ptr<std::streambuf> buf_, Type type_, bool text_, glui32 rock_);
             ~Latin1Stream();
             
             glui32 position() const final;
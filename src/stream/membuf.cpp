@@ -1,20 +1,15 @@
 #include "membuf.hpp"
 
 #include <cassert>
-#include <limits>
-
-#include <buffer/buffer_view.hpp>
 
 template<bool ReadOnly>
 Glk::MemBuf<ReadOnly>::MemBuf(char_type* buffer_, glui32 length_)
-        : m_Buffer{buffer_, length_} {}
+        : m_Area{const_cast<char*>(buffer_), length_, !ReadOnly} {}
 
 template<bool ReadOnly>
 typename Glk::MemBuf<ReadOnly>::int_type Glk::MemBuf<ReadOnly>::overflow(int_type ch) {
     if constexpr(!ReadOnly) {
-        if(m_Position < (std::streamsize)m_Buffer.size())
-            m_Buffer[m_Position] = ch;
-        m_Position += 1;
+        m_Area.put(traits_type::to_char_type(ch));
         return traits_type::not_eof(ch);
     } else {
         return std::streambuf::overflow(ch);
@@ -29,19 +24,20 @@ typename Glk::MemBuf<ReadOnly>::pos_type Glk::MemBuf<ReadOnly>::seekoff(off_type
             return seekpos(off, openmode);
 
         case std::ios_base::cur:
-            return seekpos(m_Position + off, openmode);
+            return seekpos(m_Area.position() + off, openmode);
 
         case std::ios_base::end:
-            return seekpos(off_type(m_Buffer.size()) + off, openmode);
+            return seekpos(off_type(m_Area.size()) + off, openmode);
     }
 
-    return m_Position;
+    return m_Area.position();
 }
 
 template<bool ReadOnly>
 typename Glk::MemBuf<ReadOnly>::pos_type Glk::MemBuf<ReadOnly>::seekpos(pos_type off,
                                                                         std::ios_base::openmode openmode) {
-    return (m_Position = off);
+    m_Area.setPosition(off);
+    return m_Area.position();
 }
 
 template<bool ReadOnly>
@@ -55,29 +51,15 @@ typename Glk::MemBuf<ReadOnly>::int_type Glk::MemBuf<ReadOnly>::underflow() {
 
 template<bool ReadOnly>
 std::streamsize Glk::MemBuf<ReadOnly>::xsgetn(char* s, std::streamsize n) {
-    buffer::byte_buffer_span buf{s, static_cast<size_t>(n)};
-
-    std::streamsize copycount = 0;
-    if(m_Position < std::streamsize(m_Buffer.size()))
-        copycount = buf.copy_from(m_Buffer.subview(m_Position));
-    m_Position += copycount;
-
-    return copycount;
+    return std::streamsize(m_Area.read(s, std::size_t(n)));
 }
 
 template<bool ReadOnly>
 std::streamsize Glk::MemBuf<ReadOnly>::xsputn(const char* s, std::streamsize count) {
-    if constexpr(!ReadOnly) {
-        buffer::buffer_view<char> buf{s, static_cast<size_t>(count)};
-
-        if(m_Position < std::streamsize(m_Buffer.size()))
-            buf.copy_to(m_Buffer.subspan(m_Position));
-        m_Position += buf.size();
-
-        return buf.size();
-    } else {
+    if constexpr(!ReadOnly)
+        return std::streamsize(m_Area.write(s, std::size_t(count)));
+    else
         return std::streambuf::xsputn(s, count);
-    }
 }
 
 template<bool ReadOnly>
@@ -85,15 +67,15 @@ Glk::RegisteredMemBuf<ReadOnly>::RegisteredMemBuf(typename MemBuf<ReadOnly>::cha
                                                   bool unicode_)
         : MemBuf<ReadOnly>(buffer_, length_),
           m_Unicode{unicode_} {
-    QGlk::getMainWindow().dispatch().registerArray((void*) (this->buffer().data()),
-                                                   m_Unicode ? this->buffer().size()/sizeof(glui32) : this->buffer().size(),
+    QGlk::getMainWindow().dispatch().registerArray((void*) (this->area().data()),
+                                                   m_Unicode ? this->area().size()/sizeof(glui32) : this->area().size(),
                                                    m_Unicode);
 }
 
 template<bool ReadOnly>
 Glk::RegisteredMemBuf<ReadOnly>::~RegisteredMemBuf() {
-    QGlk::getMainWindow().dispatch().unregisterArray((void*) (this->buffer().data()),
-                                                     m_Unicode ? this->buffer().size()/sizeof(glui32) : this->buffer().size(),
+    QGlk::getMainWindow().dispatch().unregisterArray((void*) (this->area().data()),
+                                                     m_Unicode ? this->area().size()/sizeof(glui32) : this->area().size(),
                                                      m_Unicode);
 }
 
@@ -3,21 +3,25 @@
 
 #include <streambuf>
 
-#include <buffer/buffer_span.hpp>
-#include <buffer/buffer_view.hpp>
-
 #include "qglk.hpp"
 
+#include "memoryarea.hpp"
+
 namespace Glk {
     template <bool ReadOnly>
-    class MemBuf : public std::streambuf {
-            using buffer_type = std::conditional_t<ReadOnly, buffer::byte_buffer_view, buffer::byte_buffer_span>;
+    class MemBuf : public std::streambuf, public PoolAllocated {
         public:
             using char_type = std::conditional_t<ReadOnly, const char, char>;
 
 
             MemBuf(char_type* buffer_, glui32 length_);
 
+
+            /// The buffer and position, for streams that read and write them directly.
+            [[nodiscard]] inline MemoryArea& area() {
+                return m_Area;
+            }
+
         protected:
             int_type overflow(int_type ch) final;
             int_type underflow() final;
@@ -28,15 +32,8 @@ namespace Glk {
             std::streamsize xsgetn(char* s, std::streamsize count) final;
             std::streamsize xsputn(const char* s, std::streamsize count) final;
 
-
-            [[nodiscard]] inline const buffer_type& buffer() const {
-                return m_Buffer;
-            }
-
         private:
-            buffer_type m_Buffer;
-
-            std::streamsize m_Position{0};
+            MemoryArea m_Area;
     };
 
     template <bool ReadOnly>
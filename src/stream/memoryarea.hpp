@@ -0,0 +1,80 @@
+#ifndef QGLK_MEMORYAREA_HPP
+#define QGLK_MEMORYAREA_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <ios>
+
+namespace Glk {
+    /// The buffer behind a memory stream and the position in it, shared by the stream's MemBuf and the stream's
+    ///   own fast paths, so both always see the same position. The position may run past the end of the buffer:
+    ///   what is written there is counted but dropped.
+    class MemoryArea {
+        public:
+            MemoryArea(char* data_, std::size_t size_, bool writable_)
+                : mp_Data{data_},
+                  m_Size{size_},
+                  m_Writable{writable_} {}
+
+
+            [[nodiscard]] inline char* data() const {
+                return mp_Data;
+            }
+
+            [[nodiscard]] inline std::size_t size() const {
+                return m_Size;
+            }
+
+            [[nodiscard]] inline std::streamsize position() const {
+                return m_Position;
+            }
+
+            inline void setPosition(std::streamsize pos) {
+                m_Position = std::max<std::streamsize>(pos, 0);
+            }
+
+            /// Returns how much was written, which is count unless the buffer is read only.
+            inline std::size_t write(const char* src, std::size_t count) {
+                if(!m_Writable)
+                    return 0;
+
+                if(std::size_t(m_Position) < m_Size)
+                    std::memcpy(mp_Data + m_Position, src, std::min(count, m_Size - std::size_t(m_Position)));
+                m_Position += std::streamsize(count);
+
+                return count;
+            }
+
+            inline std::size_t put(char ch) {
+                if(!m_Writable)
+                    return 0;
+
+                if(std::size_t(m_Position) < m_Size)
+                    mp_Data[m_Position] = ch;
+                m_Position++;
+
+                return 1;
+            }
+
+            inline std::size_t read(char* dst, std::size_t count) {
+                if(std::size_t(m_Position) >= m_Size)
+                    return 0;
+
+                count = std::min(count, m_Size - std::size_t(m_Position));
+                std::memcpy(dst, mp_Data + m_Position, count);
+                m_Position += std::streamsize(count);
+
+                return count;
+            }
+
+        private:
+            char* mp_Data;
+            std::size_t m_Size;
+            bool m_Writable;
+
+            std::streamsize m_Position{0};
+    };
+}
+
+#endif //QGLK_MEMORYAREA_HPP
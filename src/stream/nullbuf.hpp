@@ -7,7 +7,7 @@
 #include "qglk.hpp"
 
 namespace Glk {
-    class NullBuf final : public std::streambuf {
+    class NullBuf final : public std::streambuf, public PoolAllocated {
         protected:
             int_type overflow(int_type ch = traits_type::eof()) override;
 
@@ -11,8 +11,8 @@
 
 #include "log/log.hpp"
 
-Glk::Stream::Stream(QObject* parent_, std::unique_ptr<std::streambuf> buf_, Type type_, bool text_, bool unicode_, glui32 rock_)
-        : QObject{parent_},
+Glk::Stream::Stream(std::unique_ptr<std::streambuf> buf_, Type type_, bool text_, bool unicode_, glui32 rock_)
+        : Object{rock_},
           m_Type{type_},
           m_TextMode{text_},
           m_Unicode{unicode_},
@@ -20,22 +20,25 @@ Glk::Stream::Stream(QObject* parent_, std::unique_ptr<std::streambuf> buf_, Type
     assert(mp_Streambuf);
     {
         QGlk::getMainWindow().dispatch().registerObject(this);
-        QGlk::getMainWindow().streamList().push_back(this);
-        SPDLOG_DEBUG("Stream {} appended to stream list", *this);
+        QGlk::getMainWindow().streamTable().insert(this);
+        SPDLOG_DEBUG("Stream {} added to stream table", *this);
     }
 }
 
 Glk::Stream::~Stream() {
-    emit closed();
+    /* observers may stop watching from their callback, so the list is unlinked as it is walked */
+    while(mp_Observers) {
+        StreamObserver* observer = mp_Observers;
+        mp_Observers = observer->mp_NextObserver;
+        observer->mp_NextObserver = nullptr;
+        observer->streamClosed(this);
+    }
 
     {
-        auto& strList = QGlk::getMainWindow().streamList();
-        if(std::count(strList.begin(), strList.end(), this) == 0) {
-            spdlog::warn("Stream {} not found in stream list while removing", *this);
-        } else {
-            strList.remove(this);
-            SPDLOG_DEBUG("Stream {} removed from stream list", *this);
-        }
+        if(!QGlk::getMainWindow().streamTable().remove(this))
+            spdlog::warn("Stream {} not found in stream table while removing", *this);
+        else
+            SPDLOG_DEBUG("Stream {} removed from stream table", *this);
 
         QGlk::getMainWindow().dispatch().unregisterObject(this);
     }
@@ -48,4 +51,21 @@ Glk::Object::Type Glk::Stream::objectType() const {
     return Object::Type::Stream;
 }
 
+void Glk::Stream::addObserver(Glk::StreamObserver* observer) {
+    assert(!observer->mp_NextObserver);
+
+    observer->mp_NextObserver = mp_Observers;
+    mp_Observers = observer;
+}
+
+void Glk::Stream::removeObserver(Glk::StreamObserver* observer) {
+    for(StreamObserver** link = &mp_Observers; *link; link = &(*link)->mp_NextObserver) {
+        if(*link == observer) {
+            *link = observer->mp_NextObserver;
+            observer->mp_NextObserver = nullptr;
+            return;
+        }
+    }
+}
+
 void Glk::Stream::pushStyle(Style::Type sty) {}
@@ -1,11 +1,10 @@
 #ifndef STREAM_STREAM_HPP
 #define STREAM_STREAM_HPP
 
+#include <filesystem>
 #include <memory>
 #include <streambuf>
 
-#include <QObject>
-
 #include <bit_cast.hpp>
 
 #include <buffer/buffer_span.hpp>
@@ -14,18 +13,38 @@
 #include <fmt/format.h>
 
 #include "glk.hpp"
+#include "objectpool.hpp"
+
+#include "memoryarea.hpp"
 
 #include "window/style.hpp"
 
 namespace Glk {
-    class Stream : public QObject, public Object {
-            Q_OBJECT
+    class Stream;
+
+    /// Told when a stream it watches is closed. The observers of a stream are an intrusive list, so watching a
+    ///   stream allocates nothing, and an observer watches at most one stream at a time.
+    class StreamObserver {
+            friend class Stream;
+
+        public:
+            virtual void streamClosed(Stream* str) = 0;
+
+        protected:
+            StreamObserver() = default;
+            ~StreamObserver() = default;
+
+        private:
+            StreamObserver* mp_NextObserver{nullptr};
+    };
+
+    class Stream : public Object, public PoolAllocated {
         public:
             enum class Type {
                 Memory, File, Resource, Window
             };
 
-            Stream(QObject* parent_, std::unique_ptr<std::streambuf> buf_, Type type_, bool text_, bool unicode_, glui32 rock_);
+            Stream(std::unique_ptr<std::streambuf> buf_, Type type_, bool text_, bool unicode_, glui32 rock_);
             virtual ~Stream();
 
             Glk::Object::Type objectType() const override;
@@ -34,6 +53,14 @@ namespace Glk {
                 return m_Type;
             }
 
+            /// The path of the file behind a file stream, empty for any other kind of stream.
+            inline const std::filesystem::path& filePath() const {
+                return m_FilePath;
+            }
+            inline void setFilePath(std::filesystem::path path) {
+                m_FilePath = std::move(path);
+            }
+
             virtual void pushStyle(Style::Type sty);
             
             virtual void pushHyperlink(glui32 linkval) {}
@@ -55,28 +82,51 @@ namespace Glk {
                 return m_TextMode;
             }
 
+            /// Set for memory streams, whose buffer the inline read and write methods below then use directly
+            ///   instead of going through the virtual methods and the streambuf. The area belongs to the streambuf.
+            inline void setMemoryArea(MemoryArea* area) {
+                mp_Memory = area;
+            }
+
 
             // ASCII write methods
             inline void writeBuffer(char* buf, glui32 len) {
-                writeBuffer(buffer::byte_buffer_view{buf, len});
+                if(mp_Memory && !m_Unicode)
+                    updateWriteCount(glui32(mp_Memory->write(buf, len)));
+                else
+                    writeBuffer(buffer::byte_buffer_view{buf, len});
             }
             inline void writeString(char* str) {
-                writeBuffer(buffer::byte_buffer_view{str, std::basic_string_view<char>{str}.length()});
+                writeBuffer(str, glui32(std::basic_string_view<char>{str}.length()));
             }
             inline void writeChar(unsigned char ch) {
-                writeBuffer(buffer::byte_buffer_view{reinterpret_cast<char*>(&ch), 1});
+                if(mp_Memory && !m_Unicode)
+                    updateWriteCount(glui32(mp_Memory->put(bit_cast<char>(ch))));
+                else if(mp_Memory)
+                    writeUnicodeChar(ch);
+                else
+                    writeBuffer(buffer::byte_buffer_view{reinterpret_cast<char*>(&ch), 1});
             }
             virtual void writeBuffer(buffer::byte_buffer_view buf) = 0;
 
             // Unicode write methods
             inline void writeUnicodeBuffer(glui32* buf, glui32 len) {
-                writeUnicodeBuffer(buffer::buffer_view<glui32>{buf, len});
+                if(mp_Memory && m_Unicode)
+                    updateWriteCount(glui32(mp_Memory->write(reinterpret_cast<char*>(buf), sizeof(glui32) * len) /
+                                            sizeof(glui32)));
+                else
+                    writeUnicodeBuffer(buffer::buffer_view<glui32>{buf, len});
             }
             inline void writeUnicodeString(glui32* str) {
-                writeUnicodeBuffer(buffer::buffer_view<glui32>{str, std::basic_string_view<glui32>{str}.length()});
+                writeUnicodeBuffer(str, glui32(std::basic_string_view<glui32>{str}.length()));
             }
             inline void writeUnicodeChar(glui32 ch) {
-                writeUnicodeBuffer(buffer::buffer_view<glui32>{&ch, 1});
+                if(mp_Memory && m_Unicode)
+                    writeUnicodeBuffer(&ch, 1);
+                else if(mp_Memory)
+                    writeChar((ch >= 0x100) ? '?' : static_cast<unsigned char>(ch));
+                else
+                    writeUnicodeBuffer(buffer::buffer_view<glui32>{&ch, 1});
             }
             virtual void writeUnicodeBuffer(buffer::buffer_view<glui32> buf) = 0;
 
@@ -86,6 +136,12 @@ namespace Glk {
                 return (readBuffer(&ch, 1) == 1) ? bit_cast<unsigned char>(ch) : -1;
             }
             inline glui32 readBuffer(char* buf, glui32 len) {
+                if(mp_Memory && !m_Unicode) {
+                    auto numr = glui32(mp_Memory->read(buf, len));
+                    updateReadCount(numr);
+                    return numr;
+                }
+
                 return readBuffer({buf, len});
             }
             virtual glui32 readBuffer(buffer::byte_buffer_span buf) = 0;
@@ -100,6 +156,13 @@ namespace Glk {
                 return (readUnicodeBuffer(&ch, 1) == 1) ? ch : -1;
             }
             inline glui32 readUnicodeBuffer(glui32* buf, glui32 len) {
+                if(mp_Memory && m_Unicode) {
+                    auto numr = glui32(mp_Memory->read(reinterpret_cast<char*>(buf), sizeof(glui32) * len) /
+                                       sizeof(glui32));
+                    updateReadCount(numr);
+                    return numr;
+                }
+
                 return readUnicodeBuffer({buf, len});
             }
             virtual glui32 readUnicodeBuffer(buffer::buffer_span<glui32> buf) = 0;
@@ -108,8 +171,9 @@ namespace Glk {
             }
             virtual glui32 readUnicodeLine(buffer::buffer_span<glui32> buf) = 0;
 
-        signals:
-            void closed();
+
+            void addObserver(StreamObserver* observer);
+            void removeObserver(StreamObserver* observer);
 
         protected:
             inline std::streambuf* streambuf() const {
@@ -128,6 +192,9 @@ namespace Glk {
             bool m_Unicode;
 
             std::unique_ptr<std::streambuf> mp_Streambuf;
+            std::filesystem::path m_FilePath;
+            StreamObserver* mp_Observers{nullptr};
+            MemoryArea* mp_Memory{nullptr};
 
             glui32 m_ReadChars{0};
             glui32 m_WriteChars{0};
@@ -138,6 +205,9 @@ inline strid_t TO_STRID(Glk::Stream* str) {
     return reinterpret_cast<strid_t>(str);
 }
 inline Glk::Stream* FROM_STRID(strid_t str) {
+    if(str && Glk::validatingHandles())
+        Glk::validateHandle(str, Glk::Object::Stream);
+
     return reinterpret_cast<Glk::Stream*>(str);
 }
 
@@ -7,8 +7,8 @@
 
 #include <QtEndian>
 
-Glk::UnicodeStream::UnicodeStream(QObject* parent_, std::unique_ptr<std::streambuf> buf_, Type type_, bool text_, glui32 rock_)
-        : Stream(parent_, std::move(buf_), type_, text_, true, rock_) {}
+Glk::UnicodeStream::UnicodeStream(std::unique_ptr<std::streambuf> buf_, Type type_, bool text_, glui32 rock_)
+        : Stream(std::move(buf_), type_, text_, true, rock_) {}
 
 Glk::UnicodeStream::~UnicodeStream() = default;
 
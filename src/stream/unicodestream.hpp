@@ -5,9 +5,8 @@
 
 namespace Glk {
     class UnicodeStream : public Stream {
-            Q_OBJECT
         public:
-            UnicodeStream(QObject* parent_, std::unique_ptr<std::streambuf> buf_, Type type_, bool text_, glui32 rock_);
+            UnicodeStream(std::unique_ptr<std::streambuf> buf_, Type type_, bool text_, glui32 rock_);
             virtual ~UnicodeStream();
 
             glui32 position() const override;
@@ -12,7 +12,7 @@ QPoint Glk::BlankWindowController::glkPos(const QPoint& qtPos) const {
     return qtPos;
 }
 
-QSize Glk::BlankWindowController::glkSize() const {
+QSize Glk::BlankWindowController::computeGlkSize() const {
     return widget()->size();
 }
 
@@ -10,11 +10,6 @@
 
 #include "window/windowcontroller.hpp"
 
-#include "pairwidget.hpp"
-#include "pairwindowcontroller.hpp"
-
-class QGridLayout;
-
 namespace Glk {
     class Window;
 
@@ -87,13 +82,6 @@ namespace Glk {
                 return isVertical(method());
             }
 
-            virtual void setupWidgets(PairWindowController* parentController) const = 0;
-
-        protected:
-            QGridLayout* setupLayout(PairWidget* parent) const;
-
-            void showChildWidgets(PairWindowController* parentController) const;
-
         private:
             Method m_Method;
             glui32 m_Size;
@@ -112,8 +100,6 @@ namespace Glk {
             inline bool constrainsRight() const {
                 return (method() & 1) != 0;
             }
-
-            void setupWidgets(PairWindowController* parentController) const override;
     };
 
     class VerticalWindowConstraint : public WindowArrangement {
@@ -129,8 +115,6 @@ namespace Glk {
             inline bool constrainsBelow() const {
                 return WindowArrangement::isVertical(method()) && (method() & 1) != 0;
             }
-
-            void setupWidgets(PairWindowController* parentController) const override;
     };
 }
 
@@ -0,0 +1,93 @@
+#include "glyphatlas.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include <QFontMetrics>
+#include <QPainter>
+
+std::map<QString, Glk::GlyphAtlas::Entry> Glk::GlyphAtlas::s_Atlases;
+std::uint64_t Glk::GlyphAtlas::s_Uses{0};
+
+Glk::GlyphAtlas& Glk::GlyphAtlas::get(const QFont& font, const QColor& color, qreal devicePixelRatio) {
+    QString key = QStringLiteral("%1|%2|%3").arg(font.key(), color.name(QColor::HexArgb)).arg(devicePixelRatio);
+
+    auto& entry = s_Atlases[key];
+    entry.lastUse = ++s_Uses;
+    if(entry.atlas)
+        return *entry.atlas;
+
+    entry.atlas.reset(new GlyphAtlas{font, color, devicePixelRatio});
+
+    if(s_Atlases.size() > MAX_ATLASES) {
+        auto oldest = std::min_element(s_Atlases.begin(), s_Atlases.end(), [](const auto& a, const auto& b) {
+            return a.second.lastUse < b.second.lastUse;
+        });
+        s_Atlases.erase(oldest);
+    }
+
+    return *entry.atlas;
+}
+
+Glk::GlyphAtlas::GlyphAtlas(const QFont& font, const QColor& color, qreal devicePixelRatio)
+    : m_Font{font},
+      m_Color{color},
+      m_DevicePixelRatio{devicePixelRatio},
+      m_CellSize{},
+      m_DeviceCellSize{},
+      m_Ascent{},
+      m_Image{},
+      m_Index{} {
+    QFontMetrics metrics{m_Font};
+    m_CellSize = {metrics.horizontalAdvance('m'), metrics.height()};
+    m_DeviceCellSize = {int(std::ceil(m_CellSize.width() * m_DevicePixelRatio)),
+                        int(std::ceil(m_CellSize.height() * m_DevicePixelRatio))};
+    m_Ascent = metrics.ascent();
+
+    m_Image = QImage{m_DeviceCellSize.width() * COLUMNS, m_DeviceCellSize.height() * INITIAL_ROWS,
+                     QImage::Format_ARGB32_Premultiplied};
+    m_Image.fill(Qt::transparent);
+    m_Image.setDevicePixelRatio(m_DevicePixelRatio);
+}
+
+QRect Glk::GlyphAtlas::glyph(char32_t ch) {
+    auto it = m_Index.find(ch);
+    int index;
+
+    if(it != m_Index.end()) {
+        index = it->second;
+    } else {
+        index = int(m_Index.size());
+        if(index >= COLUMNS * (m_Image.height() / m_DeviceCellSize.height()))
+            grow();
+
+        /* the painter works in logical pixels, the image's device pixel ratio scales it up */
+        QPointF origin{qreal(index % COLUMNS) * m_DeviceCellSize.width() / m_DevicePixelRatio,
+                       qreal(index / COLUMNS) * m_DeviceCellSize.height() / m_DevicePixelRatio};
+
+        QPainter painter{&m_Image};
+        painter.setFont(m_Font);
+        painter.setPen(m_Color);
+        painter.setClipRect(QRectF{origin, QSizeF{m_CellSize}});
+        painter.drawText(origin + QPointF{0, qreal(m_Ascent)}, QString::fromUcs4(&ch, 1));
+
+        m_Index.emplace(ch, index);
+    }
+
+    return {(index % COLUMNS) * m_DeviceCellSize.width(), (index / COLUMNS) * m_DeviceCellSize.height(),
+            m_DeviceCellSize.width(), m_DeviceCellSize.height()};
+}
+
+void Glk::GlyphAtlas::grow() {
+    QImage grown{m_Image.width(), m_Image.height() * 2, QImage::Format_ARGB32_Premultiplied};
+    grown.fill(Qt::transparent);
+    grown.setDevicePixelRatio(m_DevicePixelRatio);
+
+    {
+        QPainter painter{&grown};
+        painter.setCompositionMode(QPainter::CompositionMode_Source);
+        painter.drawImage(QPointF{0, 0}, m_Image);
+    }
+
+    m_Image = std::move(grown);
+}
@@ -0,0 +1,70 @@
+#ifndef GLYPHATLAS_HPP
+#define GLYPHATLAS_HPP
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <unordered_map>
+
+#include <QColor>
+#include <QFont>
+#include <QImage>
+
+namespace Glk {
+    /// The glyphs of one font in one colour, rendered once into cells of a single image so a text grid can be
+    ///   drawn by copying cells out of it. Glyphs are rendered the first time they are asked for, and atlases are
+    ///   shared by every grid using the same font, colour and device pixel ratio. At most MAX_ATLASES are kept, and
+    ///   the one used longest ago makes way for a new one, so a reference from get() stays good only until that
+    ///   many other atlases have been asked for. Only used on the event thread.
+    class GlyphAtlas {
+            Q_DISABLE_COPY(GlyphAtlas)
+
+            static constexpr int COLUMNS = 32;
+            static constexpr int INITIAL_ROWS = 4;
+
+            /* well above the one atlas per style a text grid holds on to while painting */
+            static constexpr std::size_t MAX_ATLASES = 32;
+
+            struct Entry {
+                std::unique_ptr<GlyphAtlas> atlas;
+                std::uint64_t lastUse;
+            };
+
+        public:
+            [[nodiscard]] static GlyphAtlas& get(const QFont& font, const QColor& color, qreal devicePixelRatio);
+
+            /// Size of a glyph cell in logical pixels.
+            [[nodiscard]] inline QSize cellSize() const {
+                return m_CellSize;
+            }
+
+            [[nodiscard]] inline const QImage& image() const {
+                return m_Image;
+            }
+
+            /// Where the glyph is in image(), in the image's own pixels.
+            [[nodiscard]] QRect glyph(char32_t ch);
+
+        private:
+            GlyphAtlas(const QFont& font, const QColor& color, qreal devicePixelRatio);
+
+            void grow();
+
+
+            static std::map<QString, Entry> s_Atlases;
+            static std::uint64_t s_Uses;
+
+            QFont m_Font;
+            QColor m_Color;
+            qreal m_DevicePixelRatio;
+
+            QSize m_CellSize;
+            QSize m_DeviceCellSize;
+            int m_Ascent;
+
+            QImage m_Image;
+            std::unordered_map<char32_t, int> m_Index;
+    };
+}
+
+#endif //GLYPHATLAS_HPP
@@ -0,0 +1,121 @@
+#include "graphicssurface.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+Glk::GraphicsSurface::GraphicsSurface(QSize size)
+    : m_Buffers{},
+      m_Size{},
+      m_TileCount{},
+      m_Back{0},
+      m_Damage{},
+      m_Missing{},
+      m_Ready{1},
+      m_Front{2} {
+    QImage blank{size, FORMAT};
+    blank.fill(Qt::transparent);
+
+    for(auto& buffer : m_Buffers)
+        buffer = blank.copy();
+
+    resize(size);
+}
+
+void Glk::GraphicsSurface::damage(const QRect& rect) {
+    QRect clipped = rect & QRect{QPoint{0, 0}, m_Size};
+    if(clipped.isEmpty())
+        return;
+
+    for(int yy = clipped.top() / TILE_SIZE; yy <= clipped.bottom() / TILE_SIZE; yy++) {
+        auto row = m_Damage.begin() + yy * m_TileCount.width();
+        std::fill(row + clipped.left() / TILE_SIZE, row + clipped.right() / TILE_SIZE + 1, 1);
+    }
+}
+
+QRegion Glk::GraphicsSurface::publish() {
+    QRegion damaged = region(m_Damage);
+    if(damaged.isEmpty())
+        return damaged;
+
+    int published = m_Back;
+    m_Back = m_Ready.exchange(published | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+
+    for(int ii = 0; ii < BUFFER_COUNT; ii++) {
+        if(ii == published)
+            continue;
+
+        std::transform(m_Missing[ii].begin(), m_Missing[ii].end(), m_Damage.begin(), m_Missing[ii].begin(),
+                       [](std::uint8_t missing, std::uint8_t damage) { return missing | damage; });
+    }
+    std::fill(m_Missing[published].begin(), m_Missing[published].end(), 0);
+    std::fill(m_Damage.begin(), m_Damage.end(), 0);
+
+    /* the widget only ever reads the published buffer, so it can be copied from while it is on screen */
+    copyRegion(m_Buffers[published], m_Buffers[m_Back], region(m_Missing[m_Back]));
+    std::fill(m_Missing[m_Back].begin(), m_Missing[m_Back].end(), 0);
+
+    return damaged;
+}
+
+void Glk::GraphicsSurface::resize(QSize size) {
+    if(size != m_Buffers[m_Back].size()) {
+        /* pixels beyond the old size come out transparent */
+        QImage latest = m_Buffers[m_Back].copy(QRect{QPoint{0, 0}, size});
+
+        for(auto& buffer : m_Buffers)
+            buffer = latest.copy();
+    }
+
+    m_Size = size;
+    m_TileCount = {(size.width() + TILE_SIZE - 1) / TILE_SIZE, (size.height() + TILE_SIZE - 1) / TILE_SIZE};
+
+    std::size_t tiles = std::size_t(m_TileCount.width()) * m_TileCount.height();
+    for(auto& missing : m_Missing)
+        missing.assign(tiles, 0);
+
+    /* the widget has to take the resized buffers whole */
+    m_Damage.assign(tiles, 1);
+}
+
+const QImage& Glk::GraphicsSurface::frontBuffer() {
+    if(m_Ready.load(std::memory_order_relaxed) & FRESH)
+        m_Front = m_Ready.exchange(m_Front, std::memory_order_acq_rel) & INDEX_MASK;
+
+    return m_Buffers[m_Front];
+}
+
+void Glk::GraphicsSurface::copyRegion(const QImage& source, QImage& target, const QRegion& region) {
+    int bytesPerPixel = source.depth() / 8;
+
+    for(const QRect& rect : region) {
+        for(int yy = rect.top(); yy <= rect.bottom(); yy++) {
+            std::memcpy(target.scanLine(yy) + rect.left() * bytesPerPixel,
+                        source.constScanLine(yy) + rect.left() * bytesPerPixel,
+                        std::size_t(rect.width()) * bytesPerPixel);
+        }
+    }
+}
+
+QRegion Glk::GraphicsSurface::region(const Glk::GraphicsSurface::Tiles& tiles) const {
+    QRegion result;
+    QRect bounds{QPoint{0, 0}, m_Size};
+
+    for(int yy = 0; yy < m_TileCount.height(); yy++) {
+        auto row = tiles.begin() + yy * m_TileCount.width();
+
+        for(int xx = 0; xx < m_TileCount.width();) {
+            if(!row[xx]) {
+                xx++;
+                continue;
+            }
+
+            int first = xx;
+            while(xx < m_TileCount.width() && row[xx])
+                xx++;
+
+            result += QRect{first * TILE_SIZE, yy * TILE_SIZE, (xx - first) * TILE_SIZE, TILE_SIZE} & bounds;
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,81 @@
+#ifndef GRAPHICSSURFACE_HPP
+#define GRAPHICSSURFACE_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include <QImage>
+#include <QRegion>
+
+namespace Glk {
+    /// The pixels of a graphics window, triple buffered between the glk thread and the widget showing them.
+    ///   The glk thread draws into the back buffer, and synchronization publishes it while the glk thread is
+    ///   blocked, which swaps it with the ready buffer in one atomic exchange. The widget takes the newest ready buffer as its front buffer when it
+    ///   paints, so neither side ever waits for the other or copies the whole surface. Damage is tracked in tiles
+    ///   of TILE_SIZE pixels square. After publishing, only the tiles the new back buffer missed are copied into
+    ///   it.
+    class GraphicsSurface {
+            Q_DISABLE_COPY(GraphicsSurface)
+
+            static constexpr int BUFFER_COUNT = 3;
+            static constexpr int INDEX_MASK = 0x3;
+            static constexpr int FRESH = 0x4; /* set on the ready buffer until the widget takes it */
+
+        public:
+            static constexpr QImage::Format FORMAT = QImage::Format_ARGB32_Premultiplied;
+            static constexpr int TILE_SIZE = 64;
+
+            explicit GraphicsSurface(QSize size);
+
+
+            /// Where the glk side draws. Anything drawn must be reported with damage() to be published.
+            [[nodiscard]] inline QImage& backBuffer() {
+                return m_Buffers[m_Back];
+            }
+
+            void damage(const QRect& rect);
+
+            /// Hands the back buffer over to the widget. Returns the damaged tiles, empty when nothing was drawn
+            ///   since the last call. Only called while the glk thread is blocked.
+            QRegion publish();
+
+            /// Resizes every buffer, keeping what was drawn. Only called while the glk thread is blocked.
+            void resize(QSize size);
+
+            [[nodiscard]] inline QSize size() const {
+                return m_Size;
+            }
+
+
+            /// The newest published buffer, for the widget to paint from.
+            [[nodiscard]] const QImage& frontBuffer();
+
+        private:
+            using Tiles = std::vector<std::uint8_t>; /* one flag per tile, row major */
+
+            static void copyRegion(const QImage& source, QImage& target, const QRegion& region);
+
+
+            /// The flagged tiles as a region, with runs of tiles in a row merged into one rectangle.
+            [[nodiscard]] QRegion region(const Tiles& tiles) const;
+
+
+            std::array<QImage, BUFFER_COUNT> m_Buffers;
+            QSize m_Size;
+            QSize m_TileCount;
+
+            /* used by the glk thread, and by the event thread only while the glk thread is blocked */
+            int m_Back;
+            Tiles m_Damage;
+            std::array<Tiles, BUFFER_COUNT> m_Missing; /* what each buffer lacks compared to the newest one */
+
+            std::atomic<int> m_Ready;
+
+            /* owned by the widget */
+            int m_Front;
+    };
+}
+
+#endif //GRAPHICSSURFACE_HPP
@@ -1,13 +1,17 @@
 #include "graphicswidget.hpp"
 
-#include <memory>
-
 #include <QPainter>
 #include <QPaintEvent>
 
+#include "graphicssurface.hpp"
+
 Glk::GraphicsWidget::GraphicsWidget() : WindowWidget{} {
     m_DefaultBackgroundColor = palette().color(QPalette::Window);
 
+    m_RescaleTimer.setSingleShot(true);
+    m_RescaleTimer.setInterval(RESCALE_DELAY);
+    connect(&m_RescaleTimer, &QTimer::timeout, this, qOverload<>(&QWidget::update));
+
     installInputFilter(this);
 }
 
@@ -17,22 +21,58 @@ void Glk::GraphicsWidget::setBackgroundColor(const QColor& c) {
     setPalette(pal);
 }
 
+void Glk::GraphicsWidget::surfaceChanged(const QRegion& region) {
+    m_PendingUpload += region;
+
+    if(m_Pixmap.size() == size())
+        update(region);
+    else
+        update();
+}
+
 void Glk::GraphicsWidget::paintEvent(QPaintEvent* event) {
     QWidget::paintEvent(event);
 
-    if(!m_Buffer.isNull()) {
-        QRect r = event->region().boundingRect();
+    if(!mp_Surface)
+        return;
 
-        std::unique_ptr<QPainter> p = std::make_unique<QPainter>(this);
-        p->drawPixmap(r, m_Buffer, r);
+    uploadDamage();
+
+    QPainter p{this};
+    if(m_Pixmap.size() == size()) {
+        for(const QRect& r : event->region())
+            p.drawPixmap(r, m_Pixmap, r);
+    } else if(m_RescaleTimer.isActive()) {
+        p.drawPixmap(QPoint{0, 0}, m_Pixmap);
+    } else {
+        /* stretched until the window has been resized to match */
+        if(m_Scaled.size() != size())
+            m_Scaled = m_Pixmap.scaled(size(), Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+
+        p.drawPixmap(QPoint{0, 0}, m_Scaled);
     }
 }
 
 void Glk::GraphicsWidget::resizeEvent(QResizeEvent* event) {
-    QWidget::resizeEvent(event);
+    m_RescaleTimer.start();
+
+    WindowWidget::resizeEvent(event);
+}
+
+void Glk::GraphicsWidget::uploadDamage() {
+    const QImage& front = mp_Surface->frontBuffer();
 
-    if(!m_Buffer.isNull())
-        m_Buffer = m_Buffer.scaled(event->size());
+    if(m_Pixmap.size() != front.size()) {
+        m_Pixmap = QPixmap::fromImage(front);
+    } else if(!m_PendingUpload.isEmpty()) {
+        QPainter p{&m_Pixmap};
+        p.setCompositionMode(QPainter::CompositionMode_Source);
+        for(const QRect& r : m_PendingUpload)
+            p.drawImage(r.topLeft(), front, r);
+    } else {
+        return;
+    }
 
-    emit resized();
+    m_PendingUpload = QRegion{};
+    m_Scaled = QPixmap{};
 }
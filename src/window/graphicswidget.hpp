@@ -1,14 +1,26 @@
 #ifndef GRAPHICSWIDGET_HPP
 #define GRAPHICSWIDGET_HPP
 
+#include <memory>
+
 #include <QColor>
 #include <QPixmap>
+#include <QRegion>
+#include <QTimer>
 
 #include "windowwidget.hpp"
 
 namespace Glk {
+    class GraphicsSurface;
+
+    /// Shows the front buffer of a graphics window's surface. The buffer is uploaded into a pixmap once and after
+    ///   that only the tiles reported damaged are uploaded again. While the widget is being resized, the old
+    ///   picture is shown as it is and only rescaled once the resizing has stopped for a moment.
     class GraphicsWidget : public WindowWidget {
         Q_OBJECT
+
+            static constexpr int RESCALE_DELAY = 100; /* ms */
+
         public:
             GraphicsWidget();
 
@@ -19,30 +31,33 @@ namespace Glk {
 
             void setBackgroundColor(const QColor& c);
 
-            inline void setBuffer(const QPixmap& buf) {
-                m_Buffer = buf;
+            inline void setSurface(std::shared_ptr<GraphicsSurface> surface) {
+                mp_Surface = std::move(surface);
             }
 
-            [[nodiscard]] inline const QPixmap& buffer() {
-                return m_Buffer;
-            }
+            /// Called after the surface published the damaged region, which is uploaded and repainted.
+            void surfaceChanged(const QRegion& region);
 
             [[nodiscard]] inline const QColor& getDefaultBackgroundColor() {
                 return m_DefaultBackgroundColor;
             }
 
-        signals:
-
-            void resized();
-
         protected:
             void paintEvent(QPaintEvent* event) override;
 
             void resizeEvent(QResizeEvent* event) override;
 
         private:
+            void uploadDamage();
+
+
             QColor m_DefaultBackgroundColor;
-            QPixmap m_Buffer;
+            std::shared_ptr<GraphicsSurface> mp_Surface;
+
+            QPixmap m_Pixmap; /* what was uploaded from the front buffer */
+            QRegion m_PendingUpload;
+            QPixmap m_Scaled; /* m_Pixmap stretched to the widget while the sizes differ */
+            QTimer m_RescaleTimer;
     };
 }
 
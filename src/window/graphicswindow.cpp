@@ -9,30 +9,30 @@
 
 Glk::GraphicsWindow::GraphicsWindow(GraphicsWindowController* winController, PairWindow* winParent, glui32 objRock)
     : Window(Type::Graphics, winController, std::make_unique<WindowBuf>(this), winParent, objRock),
-      m_Buffer{1, 1, QImage::Format_ARGB32},
+      m_Surface{std::make_shared<GraphicsSurface>(QSize{1, 1})},
       m_BGColor{} {
 }
 
 void Glk::GraphicsWindow::clearWindow() {
     assert(onGlkThread());
 
-    m_Buffer.fill(Qt::transparent);
-
-    controller()->requestSynchronization();
+    controller<GraphicsWindowController>()->pushCommand(
+            GraphicsCommand::Fill{QRect{QPoint{0, 0}, m_Surface->size()}, qRgba(0, 0, 0, 0)});
 }
 
 bool Glk::GraphicsWindow::drawImage(glui32 image, glsi32 param1, glsi32 param2, QSize size) {
     assert(onGlkThread());
 
-    QImage img = QGlk::getMainWindow().loadImage(image);
+    /* scaled draws use a prescaled copy when one is available, so the painter only has to blit */
+    QImage img = size.isValid() ? QGlk::getMainWindow().loadImage(image, size) : QGlk::getMainWindow().loadImage(image);
     if(img.isNull())
         return false;
 
-    std::unique_ptr<QPainter> p = std::make_unique<QPainter>(&m_Buffer);
-    p->setRenderHints(QPainter::Antialiasing | QPainter::SmoothPixmapTransform);
-    p->drawImage(QRect{param1, param2, size.width(), size.height()}, img);
+    /* glk_image_draw passes no size, the image is then drawn at its own size */
+    QSize target = size.isValid() ? size : img.size();
 
-    controller()->requestSynchronization();
+    controller<GraphicsWindowController>()->pushCommand(
+            GraphicsCommand::DrawImage{QRect{QPoint{param1, param2}, target}, img});
 
     return true;
 }
@@ -44,10 +44,7 @@ void Glk::GraphicsWindow::eraseRect(const QRect& rect) {
 void Glk::GraphicsWindow::fillRect(const QColor& color, const QRect& rect) {
     assert(onGlkThread());
 
-    std::unique_ptr<QPainter> p = std::make_unique<QPainter>(&m_Buffer);
-    p->fillRect(rect, color);
-
-    controller()->requestSynchronization();
+    controller<GraphicsWindowController>()->pushCommand(GraphicsCommand::Fill{rect, qPremultiply(color.rgba())});
 }
 
 void Glk::GraphicsWindow::setBackgroundColor(const QColor& color) {
@@ -55,20 +52,3 @@ void Glk::GraphicsWindow::setBackgroundColor(const QColor& color) {
 
     m_BGColor = color;
 }
-
-void Glk::GraphicsWindow::resizeBuffer(QSize newSize) {
-    assert(onEventThread());
-
-    QImage newBuffer{newSize, QImage::Format_ARGB32};
-    newBuffer.fill(Qt::transparent);
-
-    QRect dstRect = newBuffer.rect();
-    QRect srcRect = {0, 0,
-                     std::min(m_Buffer.width(), newBuffer.width()),
-                     std::min(m_Buffer.height(), newBuffer.height())};
-
-    std::unique_ptr<QPainter> p = std::make_unique<QPainter>(&newBuffer);
-    p->drawImage(dstRect, m_Buffer, srcRect);
-
-    m_Buffer = std::move(newBuffer);
-}
@@ -1,9 +1,11 @@
 #ifndef GRAPHICSWINDOW_HPP
 #define GRAPHICSWINDOW_HPP
 
+#include <memory>
+
 #include <QColor>
-#include <QImage>
 
+#include "graphicssurface.hpp"
 #include "graphicswindowcontroller.hpp"
 #include "window.hpp"
 
@@ -30,14 +32,12 @@ namespace Glk {
                 return m_BGColor;
             }
 
-            [[nodiscard]] inline const QImage& buffer() const {
-                return m_Buffer;
+            [[nodiscard]] inline const std::shared_ptr<GraphicsSurface>& surface() const {
+                return m_Surface;
             }
 
-            void resizeBuffer(QSize newSize);
-
         private:
-            QImage m_Buffer;
+            std::shared_ptr<GraphicsSurface> m_Surface;
             QColor m_BGColor;
     };
 }
@@ -1,11 +1,15 @@
 #include "graphicswindowcontroller.hpp"
 
+#include <algorithm>
+#include <optional>
+
 #include <QPainter>
 
 #include "thread/taskrequest.hpp"
 
 
 #include "qglk.hpp"
+#include "log/log.hpp"
 
 #include "graphicswidget.hpp"
 #include "graphicswindow.hpp"
@@ -15,6 +19,10 @@ Glk::GraphicsWindowController::GraphicsWindowController(Glk::PairWindow* parent,
     : WindowController(new GraphicsWindow(this, parent, rock), createWidget()) {
     window<GraphicsWindow>()->setBackgroundColor(getDefaultBackgroundColor());
 
+    Glk::sendTaskToEventThread([this]() {
+        widget<GraphicsWidget>()->setSurface(window<GraphicsWindow>()->surface());
+    });
+
     QObject::connect(widget<GraphicsWidget>(), &GraphicsWidget::resized, [this]() {
         requestSynchronization();
     });
@@ -24,6 +32,19 @@ bool Glk::GraphicsWindowController::supportsMouseInput() const {
     return true;
 }
 
+void Glk::GraphicsWindowController::flushOutput() {
+    assert(onGlkThread());
+
+    if(m_Commands.empty())
+        return;
+
+    replayCommands(*window<GraphicsWindow>()->surface());
+
+    /* a synchronization for an input request can have run since the commands were pushed */
+    if(!requiresSynchronization())
+        requestSynchronization();
+}
+
 void Glk::GraphicsWindowController::synchronize() {
     assert(onEventThread());
 
@@ -33,23 +54,27 @@ void Glk::GraphicsWindowController::synchronize() {
     QSize clampedWidgetSize = {std::max(1, widget<GraphicsWidget>()->contentsRect().width()),
                                std::max(1, widget<GraphicsWidget>()->contentsRect().height())};
 
-    if(clampedWidgetSize != window<GraphicsWindow>()->buffer().size()) {
-        window<GraphicsWindow>()->resizeBuffer(clampedWidgetSize);
-        QGlk::getMainWindow().eventQueue().push(event_t{evtype_Arrange, TO_WINID(window())});
+    GraphicsSurface& surface = *window<GraphicsWindow>()->surface();
+    if(clampedWidgetSize != surface.size()) {
+        surface.resize(clampedWidgetSize);
+        updateGlkSize();
     }
 
-    widget<GraphicsWidget>()->setBuffer(QPixmap::fromImage(window<GraphicsWindow>()->buffer()));
-    widget<GraphicsWidget>()->update();
+    /* the glk thread replayed its commands before blocking, the widget takes the buffer the next time it paints */
+    QRegion published = surface.publish();
+    if(!published.isEmpty())
+        widget<GraphicsWidget>()->surfaceChanged(published);
 
-    WindowController::synchronize();
+    /* the widget repaints the damaged region itself, a full update would throw that away */
+    markSynchronized();
 }
 
 QPoint Glk::GraphicsWindowController::glkPos(const QPoint& qtPos) const {
     return qtPos;
 }
 
-QSize Glk::GraphicsWindowController::glkSize() const {
-    return window<GraphicsWindow>()->buffer().size();
+QSize Glk::GraphicsWindowController::computeGlkSize() const {
+    return window<GraphicsWindow>()->surface()->size();
 }
 
 QSize Glk::GraphicsWindowController::toQtSize(const QSize& glk) const {
@@ -70,3 +95,87 @@ QWidget* Glk::GraphicsWindowController::createWidget() {
 
     return w;
 }
+
+void Glk::GraphicsWindowController::pushCommand(Glk::GraphicsWindowController::Command cmd) {
+    /* a fill over the whole surface hides everything recorded so far */
+    if(auto f = std::get_if<GraphicsCommand::Fill>(&cmd)) {
+        if(f->rect.contains(QRect{QPoint{0, 0}, window<GraphicsWindow>()->surface()->size()})) {
+            m_EliminatedCommands += m_Commands.size();
+            m_Commands.clear();
+        }
+    }
+
+    m_Commands.emplace_back(std::move(cmd));
+
+    requestSynchronization();
+}
+
+void Glk::GraphicsWindowController::fill(QImage& target, const QRect& rect, QRgb color) {
+    QRect clipped = rect & target.rect();
+
+    for(int yy = clipped.top(); yy <= clipped.bottom(); yy++) {
+        auto line = reinterpret_cast<QRgb*>(target.scanLine(yy)) + clipped.left();
+        std::fill_n(line, clipped.width(), color);
+    }
+}
+
+void Glk::GraphicsWindowController::optimizeCommands() {
+    QRect bounds{QPoint{0, 0}, window<GraphicsWindow>()->surface()->size()};
+    QRegion covered;
+
+    /* walking backwards, covered is what the commands after the current one replace entirely */
+    auto itKept = m_Commands.end();
+    for(auto it = m_Commands.end(); it != m_Commands.begin();) {
+        --it;
+
+        QRect rect = std::visit([](const auto& c) { return c.rect; }, *it) & bounds;
+        if(rect.isEmpty() || (QRegion{rect} - covered).isEmpty())
+            continue;
+
+        if(std::holds_alternative<GraphicsCommand::Fill>(*it))
+            covered += rect;
+
+        if(--itKept != it)
+            *itKept = std::move(*it);
+    }
+
+    size_t eliminated = itKept - m_Commands.begin();
+    m_Commands.erase(m_Commands.begin(), itKept);
+    m_EliminatedCommands += eliminated;
+}
+
+void Glk::GraphicsWindowController::replayCommands(Glk::GraphicsSurface& surface) {
+    if(m_Commands.empty())
+        return;
+
+    size_t pushed = m_Commands.size();
+    optimizeCommands();
+
+    SPDLOG_TRACE("Replaying {} graphics commands for window {} ({} eliminated, {} in total)",
+                 m_Commands.size(), wrap::ptr(window()), pushed - m_Commands.size(), m_EliminatedCommands);
+
+    QImage& target = surface.backBuffer();
+    std::optional<QPainter> painter; /* begun at the first image */
+
+    for(const auto& cmd : m_Commands) {
+        std::visit([&](const auto& c) {
+            using T = std::decay_t<decltype(c)>;
+
+            if constexpr(std::is_same_v<T, GraphicsCommand::Fill>) {
+                fill(target, c.rect, c.color);
+            }
+            if constexpr(std::is_same_v<T, GraphicsCommand::DrawImage>) {
+                if(!painter) {
+                    painter.emplace(&target);
+                    painter->setRenderHints(QPainter::Antialiasing | QPainter::SmoothPixmapTransform);
+                }
+
+                painter->drawImage(c.rect, c.image);
+            }
+
+            surface.damage(c.rect);
+        }, cmd);
+    }
+
+    m_Commands.clear();
+}
@@ -1,13 +1,36 @@
 #ifndef GRAPHICSWINDOWCONTROLLER_HPP
 #define GRAPHICSWINDOWCONTROLLER_HPP
 
+#include <variant>
+#include <vector>
+
 #include <QColor>
-#include <QPixmap>
+#include <QImage>
 
 #include "windowcontroller.hpp"
 
 namespace Glk {
+    class GraphicsSurface;
+
+    namespace GraphicsCommand {
+        /// Replaces the pixels of a rectangle, which is also how erasing and clearing are done.
+        struct Fill {
+            QRect rect;
+            QRgb color; /* premultiplied */
+        };
+
+        struct DrawImage {
+            QRect rect;
+            QImage image; /* already scaled to the rectangle when a scaled copy was available */
+        };
+    }
+
     class GraphicsWindowController : public WindowController {
+            using Command = std::variant<
+                    GraphicsCommand::Fill,
+                    GraphicsCommand::DrawImage
+            >;
+
         public:
             GraphicsWindowController(PairWindow* parent, glui32 rock);
 
@@ -16,19 +39,44 @@ namespace Glk {
 
             [[nodiscard]] bool supportsMouseInput() const override;
 
+            /// Replays the recorded commands into the back buffer, so synchronization only has to publish it.
+            void flushOutput() override;
+
             void synchronize() override;
 
             [[nodiscard]] QPoint glkPos(const QPoint& qtPos) const override;
 
-            [[nodiscard]] QSize glkSize() const override;
+            [[nodiscard]] QSize computeGlkSize() const override;
 
             [[nodiscard]] QSize toQtSize(const QSize& glk) const override;
 
 
             [[nodiscard]] QColor getDefaultBackgroundColor() const;
 
+
+            void pushCommand(Command cmd);
+
+            /// Total number of commands dropped before reaching the surface because later fills covered them.
+            [[nodiscard]] inline size_t eliminatedCommands() const {
+                return m_EliminatedCommands;
+            }
+
         private:
             [[nodiscard]] static QWidget* createWidget();
+
+
+            /// Fills straight into the image's scan lines, which is all an opaque or erasing fill needs.
+            static void fill(QImage& target, const QRect& rect, QRgb color);
+
+            /// Drops the pending commands whose pixels are entirely replaced by fills recorded after them.
+            void optimizeCommands();
+
+            /// Draws the pending commands into the surface's back buffer, with a single painter for all the images.
+            void replayCommands(GraphicsSurface& surface);
+
+
+            std::vector<Command> m_Commands;
+            size_t m_EliminatedCommands{0};
     };
 }
 
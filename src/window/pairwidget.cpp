@@ -1,36 +1,59 @@
 #include "pairwidget.hpp"
 
-#include <QChildEvent>
+#include <algorithm>
+
+#include <QResizeEvent>
 
 Glk::PairWidget::~PairWidget() {
     clearChildren();
 }
 
-void Glk::PairWidget::childEvent(QChildEvent* event) {
-    if(event->child()->isWidgetType()) {
-        QWidget* child = static_cast<QWidget*>(event->child());
-        if(event->added()) {
-            assert(!m_Children[0] || !m_Children[1]);
-
-            if(m_Children[0])
-                m_Children[1] = child;
-            else
-                m_Children[0] = child;
-        } else if(event->removed()) {
-            assert(m_Children[0] || m_Children[1]);
-            assert(child == m_Children[0] || child == m_Children[1]);
-
-            if(m_Children[0] == child)
-                m_Children[0] = nullptr;
-            else
-                m_Children[1] = nullptr;
+void Glk::PairWidget::clearChildren() {
+    /* the window widgets belong to their controllers */
+    for(QWidget* child : findChildren<QWidget*>(QString{}, Qt::FindDirectChildrenOnly))
+        child->setParent(nullptr);
+}
+
+void Glk::PairWidget::setWindowLayout(Glk::WindowLayout layout) {
+    if(layout == m_Layout && m_LayoutSize == size())
+        return;
+
+    m_Layout = std::move(layout);
+    applyLayout();
+}
+
+void Glk::PairWidget::resizeEvent(QResizeEvent* event) {
+    QWidget::resizeEvent(event);
+
+    if(m_LayoutSize != size())
+        applyLayout();
+}
+
+void Glk::PairWidget::applyLayout() {
+    m_LayoutSize = size();
+
+    std::vector<WindowLayout::Placement> placements = m_Layout.geometry(m_LayoutSize);
+
+    for(const auto& [widget, rect] : placements) {
+        if(rect.isEmpty()) {
+            widget->hide();
+            continue;
         }
+
+        if(widget->parentWidget() != this)
+            widget->setParent(this);
+
+        widget->setGeometry(rect);
+        widget->show();
     }
-}
 
-void Glk::PairWidget::clearChildren() {
-    if(m_Children[0])
-        m_Children[0]->setParent(nullptr);
-    if(m_Children[1])
-        m_Children[1]->setParent(nullptr);
+    /* widgets of windows that were closed or moved away stay out of sight until they are deleted */
+    for(QWidget* child : findChildren<QWidget*>(QString{}, Qt::FindDirectChildrenOnly)) {
+        bool placed = std::any_of(placements.begin(), placements.end(), [child](const auto& placement) {
+            return placement.widget == child;
+        });
+
+        if(!placed)
+            child->hide();
+    }
 }
@@ -1,24 +1,33 @@
 #ifndef QGLK_PAIRWIDGET_HPP
 #define QGLK_PAIRWIDGET_HPP
 
-#include <array>
-
 #include <QWidget>
 
+#include "windowlayout.hpp"
+
 namespace Glk {
+    /// The widget of a pair window. The one belonging to the root of the window tree holds the widgets of every
+    ///   window below it directly and positions them itself. The geometry is only worked out again when the
+    ///   arrangement or its own size changes.
     class PairWidget : public QWidget {
             Q_OBJECT
         public:
-            ~PairWidget();
+            ~PairWidget() override;
 
 
             void clearChildren();
 
+            void setWindowLayout(WindowLayout layout);
+
         protected:
-            void childEvent(QChildEvent* event) override;
+            void resizeEvent(QResizeEvent* event) override;
 
         private:
-            std::array<QWidget*, 2> m_Children{};
+            void applyLayout();
+
+
+            WindowLayout m_Layout;
+            QSize m_LayoutSize; /* the size m_Layout was last applied at */
     };
 
 }
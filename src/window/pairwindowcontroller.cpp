@@ -26,7 +26,7 @@ QPoint Glk::PairWindowController::glkPos(const QPoint& qtPos) const {
     return qtPos;
 }
 
-QSize Glk::PairWindowController::glkSize() const {
+QSize Glk::PairWindowController::computeGlkSize() const {
     return widget()->size();
 }
 
@@ -53,7 +53,12 @@ void Glk::PairWindowController::closeWindow() {
 void Glk::PairWindowController::synchronize() {
     assert(onEventThread());
 
-    window<PairWindow>()->arrangement()->setupWidgets(this);
+    /* the whole tree is laid out by the root pair, inside its widget */
+    PairWindow* root = window<PairWindow>();
+    while(root->parent())
+        root = root->parent();
+
+    root->controller()->widget<PairWidget>()->setWindowLayout(WindowLayout::fromTree(root));
 
     auto firstWin = window<Glk::PairWindow>()->firstWindow();
     auto secondWin = window<Glk::PairWindow>()->secondWindow();
@@ -19,7 +19,7 @@ namespace Glk {
 
             QPoint glkPos(const QPoint& qtPos) const override;
 
-            [[nodiscard]] QSize glkSize() const override;
+            [[nodiscard]] QSize computeGlkSize() const override;
 
             QSize toQtSize(const QSize& glk) const override;
 
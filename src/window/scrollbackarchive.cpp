@@ -0,0 +1,149 @@
+#include "scrollbackarchive.hpp"
+
+#include <QDataStream>
+#include <QHash>
+#include <QTextBlock>
+#include <QTextCursor>
+#include <QTextDocument>
+#include <QVector>
+
+#include "log/log.hpp"
+
+namespace {
+    class FormatTable {
+        public:
+            qint32 intern(const QTextFormat& fmt) {
+                QByteArray key;
+                {
+                    QDataStream stream{&key, QIODevice::WriteOnly};
+                    stream << fmt;
+                }
+
+                auto it = m_Index.constFind(key);
+                if(it != m_Index.cend())
+                    return *it;
+
+                m_Formats.push_back(fmt);
+                return *m_Index.insert(key, m_Formats.size() - 1);
+            }
+
+            [[nodiscard]] inline const QVector<QTextFormat>& formats() const {
+                return m_Formats;
+            }
+
+        private:
+            QHash<QByteArray, qint32> m_Index;
+            QVector<QTextFormat> m_Formats;
+    };
+}
+
+Glk::ScrollbackArchive::ScrollbackArchive() : m_LiveBlockLimit{DEFAULT_LIVE_BLOCKS}, m_Compress{true} {
+    bool ok;
+    int limit = qEnvironmentVariableIntValue("QGLK_SCROLLBACK_BLOCKS", &ok);
+    if(ok && limit >= 0)
+        m_LiveBlockLimit = limit;
+
+    if(qEnvironmentVariableIsSet("QGLK_SCROLLBACK_COMPRESS"))
+        m_Compress = qEnvironmentVariableIntValue("QGLK_SCROLLBACK_COMPRESS") != 0;
+}
+
+void Glk::ScrollbackArchive::archive(const QTextDocument& doc, int blockCount) {
+    FormatTable table;
+    QByteArray blocks;
+    {
+        QDataStream stream{&blocks, QIODevice::WriteOnly};
+        stream << qint32(blockCount);
+
+        QTextBlock block = doc.begin();
+        for(int ii = 0; ii < blockCount && block.isValid(); ii++, block = block.next()) {
+            stream << table.intern(block.blockFormat()) << block.text();
+
+            QVector<QPair<qint32, qint32>> runs;
+            for(auto it = block.begin(); !it.atEnd(); ++it) {
+                QTextFragment frag = it.fragment();
+                qint32 fmt = table.intern(frag.charFormat());
+                if(!runs.isEmpty() && runs.back().second == fmt)
+                    runs.back().first += frag.length();
+                else
+                    runs.push_back({frag.length(), fmt});
+            }
+            stream << runs;
+        }
+    }
+
+    QByteArray data;
+    {
+        QDataStream stream{&data, QIODevice::WriteOnly};
+        stream << table.formats();
+    }
+    data.append(blocks);
+
+    Page page{m_Compress ? qCompress(data) : data, m_Compress};
+    m_ArchivedBytes += size_t(page.data.size());
+    m_Pages.push_back(std::move(page));
+
+    /* past the budget the oldest scrollback is lost for good */
+    while(m_ArchivedBytes > MAX_ARCHIVE_BYTES && m_Pages.size() > 1) {
+        m_ArchivedBytes -= size_t(m_Pages.front().data.size());
+        m_Pages.pop_front();
+    }
+
+    SPDLOG_DEBUG("Archived {} blocks of scrollback into {} bytes ({} pages, {} bytes total)",
+                 blockCount, m_Pages.back().data.size(), m_Pages.size(), m_ArchivedBytes);
+}
+
+int Glk::ScrollbackArchive::restore(QTextDocument& doc) {
+    if(m_Pages.empty())
+        return 0;
+
+    Page page = std::move(m_Pages.back());
+    m_Pages.pop_back();
+    m_ArchivedBytes -= size_t(page.data.size());
+
+    QByteArray data = page.compressed ? qUncompress(page.data) : page.data;
+    QDataStream stream{data};
+
+    QVector<QTextFormat> formats;
+    qint32 blockCount;
+    stream >> formats >> blockCount;
+
+    auto fn_format = [&formats](qint32 idx) {
+        return (idx >= 0 && idx < formats.size()) ? formats[idx] : QTextFormat{};
+    };
+
+    QTextCursor cur{&doc};
+    cur.beginEditBlock();
+
+    /* split off an empty block at the very start, so the archived blocks go in ahead of the live ones untouched */
+    cur.movePosition(QTextCursor::Start);
+    cur.insertBlock();
+    cur.movePosition(QTextCursor::Start);
+
+    int restored = 0;
+    for(; restored < blockCount && !stream.atEnd(); restored++) {
+        qint32 blockFormat;
+        QString text;
+        QVector<QPair<qint32, qint32>> runs;
+        stream >> blockFormat >> text >> runs;
+
+        if(restored == 0)
+            cur.setBlockFormat(fn_format(blockFormat).toBlockFormat());
+        else
+            cur.insertBlock(fn_format(blockFormat).toBlockFormat());
+
+        int pos = 0;
+        for(const auto& run : runs) {
+            cur.insertText(text.mid(pos, run.first), fn_format(run.second).toCharFormat());
+            pos += run.first;
+        }
+    }
+
+    cur.endEditBlock();
+
+    return restored;
+}
+
+void Glk::ScrollbackArchive::clear() {
+    m_Pages.clear();
+    m_ArchivedBytes = 0;
+}
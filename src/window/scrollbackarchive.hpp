@@ -0,0 +1,56 @@
+#ifndef SCROLLBACKARCHIVE_HPP
+#define SCROLLBACKARCHIVE_HPP
+
+#include <deque>
+
+#include <QByteArray>
+
+class QTextCursor;
+class QTextDocument;
+
+namespace Glk {
+    /// Compact store for the blocks a text buffer has scrolled far out of view.
+    ///   Blocks are archived oldest first in pages. A page keeps each block as its text plus style runs that refer
+    ///   to a per-page table of interned formats, and is optionally run through qCompress. Pages come back in the
+    ///   reverse order as the user scrolls up. The number of live blocks (QGLK_SCROLLBACK_BLOCKS, 0 for no limit)
+    ///   and compression (QGLK_SCROLLBACK_COMPRESS) are read from the environment.
+    class ScrollbackArchive {
+            static constexpr int DEFAULT_LIVE_BLOCKS = 2000;
+            static constexpr size_t MAX_ARCHIVE_BYTES = 16 * 1024 * 1024;
+
+            struct Page {
+                QByteArray data;
+                bool compressed;
+            };
+
+        public:
+            ScrollbackArchive();
+
+            /// The number of blocks the live document should be trimmed down to, or 0 if there is no limit.
+            [[nodiscard]] inline int liveBlockLimit() const {
+                return m_LiveBlockLimit;
+            }
+
+            [[nodiscard]] inline bool isEmpty() const {
+                return m_Pages.empty();
+            }
+
+            /// Stores the first blockCount blocks of the document in a new page. Removing them is up to the caller.
+            void archive(const QTextDocument& doc, int blockCount);
+
+            /// Inserts the most recently archived page at the start of the document. Returns the number of
+            ///   blocks inserted.
+            int restore(QTextDocument& doc);
+
+            void clear();
+
+        private:
+            std::deque<Page> m_Pages;
+            size_t m_ArchivedBytes{0};
+
+            int m_LiveBlockLimit;
+            bool m_Compress;
+    };
+}
+
+#endif //SCROLLBACKARCHIVE_HPP
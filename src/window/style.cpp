@@ -55,6 +55,8 @@ Glk::Style::Style(Glk::Style::Type type_)
         default: // Normal, User1, User2
             break;
     }
+
+    updateFormats();
 }
 
 Qt::AlignmentFlag toAlignmentFlag(glui32 just) {
@@ -74,26 +76,6 @@ Qt::AlignmentFlag toAlignmentFlag(glui32 just) {
     }
 }
 
-QTextBlockFormat Glk::Style::blockFormat() const {
-    QTextBlockFormat blk;
-
-    blk.setAlignment(toAlignmentFlag(m_Justification));
-    blk.setIndent(0.1 * m_Indentation);
-    blk.setTextIndent(0.1 * m_ParaIndentation);
-    blk.setBottomMargin(blk.bottomMargin() * 1.5);
-
-    return blk;
-}
-
-QTextCharFormat Glk::Style::charFormat() const {
-    QTextCharFormat ch;
-
-    ch.setFont(m_Font);
-    ch.setForeground(m_TextColor);
-
-    return ch;
-}
-
 glui32 Glk::Style::getHint(glui32 hint) const {
     switch(hint) {
         case stylehint_Indentation:
@@ -250,23 +232,25 @@ void Glk::Style::setHint(glui32 hint, glui32 value) {
             m_TextColor.setRgb(value);
             break;
     }
+
+    updateFormats();
 }
 
 bool Glk::Style::operator==(const Glk::Style& other) const {
-    if(m_Indentation != other.m_Indentation)
-        return true;
-
-    if(m_ParaIndentation != other.m_ParaIndentation)
-        return true;
-
-    if(m_Justification)
-        return true;
-
-    if(m_Font != other.m_Font)
-        return true;
+    /* formats that share their data compare without looking at the properties */
+    return m_BlockFormat == other.m_BlockFormat &&
+           m_CharFormat == other.m_CharFormat &&
+           m_BackgroundColor == other.m_BackgroundColor;
+}
 
-    if(m_TextColor == other.m_TextColor)
-        return true;
+void Glk::Style::updateFormats() {
+    m_BlockFormat = QTextBlockFormat{};
+    m_BlockFormat.setAlignment(toAlignmentFlag(m_Justification));
+    m_BlockFormat.setIndent(0.1 * m_Indentation);
+    m_BlockFormat.setTextIndent(0.1 * m_ParaIndentation);
+    m_BlockFormat.setBottomMargin(m_BlockFormat.bottomMargin() * 1.5);
 
-    return (m_BackgroundColor == other.m_BackgroundColor);
+    m_CharFormat = QTextCharFormat{};
+    m_CharFormat.setFont(m_Font);
+    m_CharFormat.setForeground(m_TextColor);
 }
@@ -29,9 +29,14 @@ namespace Glk {
 
             explicit Style(Type type_ = Normal);
 
-            [[nodiscard]] QTextBlockFormat blockFormat() const;
+            /// The formats are built once and rebuilt only when a hint changes, so copying them out is cheap.
+            [[nodiscard]] inline const QTextBlockFormat& blockFormat() const {
+                return m_BlockFormat;
+            }
 
-            [[nodiscard]] QTextCharFormat charFormat() const;
+            [[nodiscard]] inline const QTextCharFormat& charFormat() const {
+                return m_CharFormat;
+            }
 
             [[nodiscard]] glui32 getHint(glui32 hint) const;
 
@@ -50,6 +55,9 @@ namespace Glk {
             }
 
         private:
+            void updateFormats();
+
+
             Type m_Type;
             QFont m_Font;
             glsi32 m_Indentation;
@@ -59,6 +67,8 @@ namespace Glk {
             QColor m_TextColor;
             QColor m_BackgroundColor;
 
+            QTextBlockFormat m_BlockFormat;
+            QTextCharFormat m_CharFormat;
     };
 }
 
@@ -1,11 +1,12 @@
 #ifndef STYLEMANAGER_HPP
 #define STYLEMANAGER_HPP
 
-#include <QHash>
+#include <array>
 
 #include "style.hpp"
 
 namespace Glk {
+    /// One style per glk style number, looked up by direct indexing. Unknown style numbers map to Normal.
     class StyleManager {
         public:
             StyleManager();
@@ -18,12 +19,20 @@ namespace Glk {
 
             StyleManager& operator=(StyleManager&&) = default;
 
-            const Style& operator[](Style::Type type) const;
+            [[nodiscard]] static inline bool isValid(glui32 type) {
+                return type < style_NUMSTYLES;
+            }
 
-            Style& operator[](Style::Type type);
+            [[nodiscard]] inline const Style& operator[](Style::Type type) const {
+                return m_Styles[isValid(type) ? type : Style::Normal];
+            }
+
+            [[nodiscard]] inline Style& operator[](Style::Type type) {
+                return m_Styles[isValid(type) ? type : Style::Normal];
+            }
 
         private:
-            QHash<Style::Type, Style> m_StyleMap;
+            std::array<Style, style_NUMSTYLES> m_Styles;
     };
 }
 
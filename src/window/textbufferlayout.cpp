@@ -0,0 +1,463 @@
+#include "textbufferlayout.hpp"
+
+#include <algorithm>
+
+#include <QFontMetricsF>
+#include <QGlyphRun>
+#include <QPainter>
+#include <QPixmap>
+#include <QTextBlock>
+#include <QTextDocument>
+#include <QTextLayout>
+
+class Glk::TextBufferLayout::BlockState : public QTextBlockUserData {
+    public:
+        struct Span {
+            QGlyphRun run;
+            QBrush foreground; /* none for the palette's text colour */
+        };
+
+        qreal height{0};
+        qreal width{-1}; /* the width the block was laid out for, or -1 if it never was */
+        qreal naturalWidth{0};
+        bool singleLeftLine{false};
+
+        bool glyphsCached{false};
+        bool simple{true}; /* no images, backgrounds or decorations, the cached glyph runs are all there is to draw */
+        std::vector<Span> spans;
+};
+
+Glk::TextBufferImageHandler::TextBufferImageHandler(QObject* parent)
+    : QObject{parent} {}
+
+QSizeF Glk::TextBufferImageHandler::intrinsicSize(QTextDocument* doc, int posInDocument, const QTextFormat& format) {
+    QTextImageFormat fmt = format.toImageFormat();
+    QImage img = image(doc, fmt);
+
+    bool hasWidth = fmt.hasProperty(QTextFormat::ImageWidth);
+    bool hasHeight = fmt.hasProperty(QTextFormat::ImageHeight);
+
+    if(hasWidth && hasHeight)
+        return {fmt.width(), fmt.height()};
+    else if(hasWidth && img.width() > 0)
+        return {fmt.width(), fmt.width() * img.height() / img.width()};
+    else if(hasHeight && img.height() > 0)
+        return {fmt.height() * img.width() / img.height(), fmt.height()};
+    else
+        return img.size();
+}
+
+void Glk::TextBufferImageHandler::drawObject(QPainter* painter, const QRectF& rect, QTextDocument* doc,
+                                             int posInDocument, const QTextFormat& format) {
+    QImage img = image(doc, format.toImageFormat());
+    if(!img.isNull())
+        painter->drawImage(rect, img);
+}
+
+QImage Glk::TextBufferImageHandler::image(QTextDocument* doc, const QTextImageFormat& format) {
+    QVariant data = doc->resource(QTextDocument::ImageResource, QUrl{format.name()});
+
+    if(data.userType() == QMetaType::QPixmap)
+        return data.value<QPixmap>().toImage();
+
+    return data.value<QImage>();
+}
+
+Glk::TextBufferLayout::TextBufferLayout(QTextDocument* doc)
+    : QAbstractTextDocumentLayout{doc},
+      m_Width{UNBOUNDED_WIDTH},
+      m_Font{doc->defaultFont()},
+      m_TextOption{doc->defaultTextOption()},
+      m_Margin{doc->documentMargin()},
+      m_Tops{},
+      m_ValidTops{0},
+      m_LayoutTimer{},
+      m_SizeChanged{false},
+      m_PendingBlock{0} {
+    registerHandler(QTextFormat::ImageObject, new TextBufferImageHandler{this});
+
+    m_LayoutTimer.setSingleShot(true);
+    m_LayoutTimer.setInterval(0);
+    connect(&m_LayoutTimer, &QTimer::timeout, this, &TextBufferLayout::layoutPending);
+}
+
+bool Glk::TextBufferLayout::isSelected() {
+#ifdef QGLK_FAST_TEXT_LAYOUT
+    static const bool selected = qEnvironmentVariable("QGLK_TEXT_LAYOUT") == QLatin1String("fast");
+
+    return selected;
+#else
+    return false;
+#endif
+}
+
+void Glk::TextBufferLayout::draw(QPainter* painter, const PaintContext& context) {
+    QRectF clip = context.clip.isValid() ? context.clip : QRectF{QPointF{0, 0}, documentSize()};
+
+    painter->save();
+
+    /* blocks are laid out top down as they are reached, so a reflowed block moves the ones below it in time */
+    QTextBlock block = blockAt(clip.top());
+    for(int ii = block.isValid() ? block.blockNumber() : 0; block.isValid(); block = block.next(), ii++) {
+        ensureLaidOut(block);
+        updateTops(ii + 1);
+
+        if(m_Tops[ii] > clip.bottom())
+            break;
+
+        if(m_Tops[ii + 1] >= clip.top())
+            drawBlock(painter, context, block, m_Tops[ii]);
+    }
+
+    painter->restore();
+}
+
+int Glk::TextBufferLayout::hitTest(const QPointF& point, Qt::HitTestAccuracy accuracy) const {
+    QTextBlock block = blockAt(point.y());
+    if(!block.isValid())
+        return accuracy == Qt::FuzzyHit ? document()->characterCount() - 1 : -1;
+
+    ensureLaidOut(block);
+    updateTops(block.blockNumber());
+
+    QTextLayout* tl = block.layout();
+    QPointF pos = point - QPointF{0, m_Tops[block.blockNumber()]};
+
+    for(int ii = 0; ii < tl->lineCount(); ii++) {
+        QTextLine line = tl->lineAt(ii);
+        if(pos.y() >= line.y() + line.height() && ii + 1 < tl->lineCount())
+            continue;
+
+        if(accuracy == Qt::ExactHit) {
+            if(pos.y() < line.y() || pos.y() > line.y() + line.height() ||
+               pos.x() < line.x() || pos.x() > line.x() + line.naturalTextWidth())
+                return -1;
+
+            return block.position() + line.xToCursor(pos.x(), QTextLine::CursorOnCharacter);
+        }
+
+        return block.position() + line.xToCursor(pos.x());
+    }
+
+    return accuracy == Qt::FuzzyHit ? block.position() : -1;
+}
+
+int Glk::TextBufferLayout::pageCount() const {
+    return 1;
+}
+
+QSizeF Glk::TextBufferLayout::documentSize() const {
+    int count = document()->blockCount();
+    updateTops(count);
+
+    qreal width = m_Width;
+    if(width >= UNBOUNDED_WIDTH) {
+        width = 0;
+        for(QTextBlock block = document()->begin(); block.isValid(); block = block.next())
+            width = std::max(width, state(block).naturalWidth);
+    }
+
+    return {width, m_Tops[count] + m_Margin};
+}
+
+QRectF Glk::TextBufferLayout::frameBoundingRect(QTextFrame* frame) const {
+    /* the root frame is the only one, the window controller inserts no floats while this layout is selected */
+    if(frame != document()->rootFrame())
+        return {};
+
+    return {QPointF{0, 0}, documentSize()};
+}
+
+QRectF Glk::TextBufferLayout::blockBoundingRect(const QTextBlock& block) const {
+    if(!block.isValid())
+        return {};
+
+    ensureLaidOut(block);
+    updateTops(block.blockNumber());
+
+    return {0, m_Tops[block.blockNumber()], m_Width, state(block).height};
+}
+
+void Glk::TextBufferLayout::documentChanged(int from, int charsRemoved, int charsAdded) {
+    QTextDocument* doc = document();
+
+    qreal width = doc->textWidth() < 0 ? UNBOUNDED_WIDTH : doc->textWidth();
+    bool widthChanged = width != m_Width;
+    if(widthChanged)
+        reflow(width);
+
+    /* a change covering the whole document is a change to the page size or to the defaults, not to the text */
+    if(from == 0 && charsRemoved == 0 && charsAdded == doc->characterCount()) {
+        if(layoutParametersChanged()) {
+            for(QTextBlock block = doc->begin(); block.isValid(); block = block.next())
+                state(block).width = -1;
+
+            m_ValidTops = 0;
+        } else if(!widthChanged) {
+            return;
+        }
+    } else {
+        QTextBlock block = doc->findBlock(from);
+        QTextBlock last = doc->findBlock(from + charsAdded);
+
+        if(block.isValid())
+            m_ValidTops = std::min(m_ValidTops, block.blockNumber() + 1);
+
+        for(; block.isValid(); block = block.next()) {
+            state(block).width = -1;
+            if(block == last)
+                break;
+        }
+    }
+
+    QSizeF size = documentSize();
+    emit documentSizeChanged(size);
+    emit update(QRectF{0, 0, size.width(), size.height()});
+}
+
+void Glk::TextBufferLayout::resizeInlineObject(QTextInlineObject item, int posInDocument, const QTextFormat& format) {
+    QAbstractTextDocumentLayout::resizeInlineObject(item, posInDocument, format);
+
+    /* top and bottom are taken care of when the line is drawn, only centring needs the object moved */
+    QTextCharFormat fmt = format.toCharFormat();
+    if(fmt.verticalAlignment() == QTextCharFormat::AlignMiddle) {
+        qreal height = item.ascent() + item.descent();
+        qreal halfX = QFontMetricsF{fmt.font()}.xHeight() / 2;
+
+        item.setAscent((height + halfX) / 2);
+        item.setDescent(height - item.ascent());
+    }
+}
+
+void Glk::TextBufferLayout::layoutPending() {
+    QTextBlock block = document()->findBlockByNumber(m_PendingBlock);
+    for(int ii = 0; ii < BACKGROUND_BATCH && block.isValid(); ii++, block = block.next())
+        ensureLaidOut(block);
+
+    if(block.isValid()) {
+        m_PendingBlock = block.blockNumber();
+        m_LayoutTimer.start();
+    } else {
+        m_PendingBlock = document()->blockCount();
+    }
+
+    if(m_SizeChanged) {
+        m_SizeChanged = false;
+
+        QSizeF size = documentSize();
+        emit documentSizeChanged(size);
+        emit update(QRectF{0, 0, size.width(), size.height()});
+    }
+}
+
+Glk::TextBufferLayout::BlockState& Glk::TextBufferLayout::state(const QTextBlock& block) {
+    auto st = static_cast<BlockState*>(block.userData());
+    if(!st) {
+        st = new BlockState;
+        QTextBlock{block}.setUserData(st);
+    }
+
+    return *st;
+}
+
+QTextBlock Glk::TextBufferLayout::blockAt(qreal y) const {
+    int count = document()->blockCount();
+    updateTops(count);
+
+    auto it = std::upper_bound(m_Tops.begin(), m_Tops.begin() + count, y);
+    int number = std::max(int(it - m_Tops.begin()) - 1, 0);
+
+    if(y > m_Tops[count])
+        return {};
+
+    return document()->findBlockByNumber(number);
+}
+
+void Glk::TextBufferLayout::cacheGlyphs(const QTextBlock& block, BlockState& st) const {
+    st.spans.clear();
+    st.simple = true;
+    st.glyphsCached = true;
+
+    QTextLayout* tl = block.layout();
+    for(auto it = block.begin(); !it.atEnd(); ++it) {
+        QTextFragment frag = it.fragment();
+        QTextCharFormat fmt = frag.charFormat();
+
+        /* glyph runs are drawn bare, so anything with a background or a line through, over or under it (which
+         * includes every hyperlink) is left to QTextLayout */
+        bool decorated = fmt.fontUnderline() || fmt.fontStrikeOut() || fmt.fontOverline() ||
+                         fmt.underlineStyle() != QTextCharFormat::NoUnderline;
+        if(fmt.objectType() != QTextFormat::NoObject || fmt.hasProperty(QTextFormat::BackgroundBrush) || decorated) {
+            st.simple = false;
+            st.spans.clear();
+            return;
+        }
+
+        QBrush foreground = fmt.hasProperty(QTextFormat::ForegroundBrush) ? fmt.foreground() : QBrush{};
+        for(const QGlyphRun& run : tl->glyphRuns(frag.position() - block.position(), frag.length()))
+            st.spans.push_back({run, foreground});
+    }
+}
+
+void Glk::TextBufferLayout::drawBlock(QPainter* painter, const PaintContext& context, const QTextBlock& block,
+                                      qreal top) {
+    BlockState& st = state(block);
+    QTextLayout* tl = block.layout();
+    QPointF offset{0, top};
+
+    int blockStart = block.position();
+    int blockEnd = blockStart + block.length();
+    bool hasCursor = context.cursorPosition >= blockStart && context.cursorPosition < blockEnd;
+
+    QVector<QTextLayout::FormatRange> selections;
+    for(const auto& sel : context.selections) {
+        int start = sel.cursor.selectionStart() - blockStart;
+        int end = sel.cursor.selectionEnd() - blockStart;
+
+        if(start < block.length() && end > 0 && end > start)
+            selections.push_back({start, end - start, sel.format});
+    }
+
+    if(!st.glyphsCached)
+        cacheGlyphs(block, st);
+
+    QPen textPen{context.palette.color(QPalette::Text)};
+
+    if(st.simple && selections.isEmpty()) {
+        for(const auto& span : st.spans) {
+            painter->setPen(span.foreground.style() == Qt::NoBrush ? textPen : QPen{span.foreground, 0});
+            painter->drawGlyphRun(offset, span.run);
+        }
+    } else {
+        painter->setPen(textPen);
+        tl->draw(painter, offset, selections, context.clip);
+    }
+
+    if(hasCursor)
+        tl->drawCursor(painter, offset, context.cursorPosition - blockStart, 1);
+}
+
+void Glk::TextBufferLayout::ensureLaidOut(const QTextBlock& block) const {
+    BlockState& st = state(block);
+    if(st.width == m_Width)
+        return;
+
+    bool estimated = st.width >= 0;
+    qreal oldHeight = st.height;
+
+    layoutBlock(block);
+
+    /* the old height stood in for the real one until now, so whatever is below has moved */
+    if(estimated && st.height != oldHeight) {
+        m_ValidTops = std::min(m_ValidTops, block.blockNumber() + 1);
+        m_SizeChanged = true;
+        m_LayoutTimer.start();
+    }
+}
+
+bool Glk::TextBufferLayout::layoutParametersChanged() {
+    QTextDocument* doc = document();
+
+    bool changed = m_Font != doc->defaultFont() || m_Margin != doc->documentMargin() ||
+                   m_TextOption.alignment() != doc->defaultTextOption().alignment() ||
+                   m_TextOption.wrapMode() != doc->defaultTextOption().wrapMode() ||
+                   m_TextOption.flags() != doc->defaultTextOption().flags() ||
+                   m_TextOption.tabStopDistance() != doc->defaultTextOption().tabStopDistance();
+
+    m_Font = doc->defaultFont();
+    m_TextOption = doc->defaultTextOption();
+    m_Margin = doc->documentMargin();
+
+    return changed;
+}
+
+void Glk::TextBufferLayout::layoutBlock(const QTextBlock& block) const {
+    BlockState& st = state(block);
+    QTextLayout* tl = block.layout();
+    QTextBlockFormat fmt = block.blockFormat();
+
+    QTextOption option = m_TextOption;
+    option.setAlignment(fmt.alignment());
+    option.setTextDirection(block.textDirection());
+
+    tl->setTextOption(option);
+    tl->setCacheEnabled(true); /* keeps the shaped text around, so reflowing only has to break lines again */
+
+    qreal left = m_Margin + fmt.leftMargin() + fmt.indent() * document()->indentWidth();
+    qreal right = m_Margin + fmt.rightMargin();
+    qreal lineWidth = std::max<qreal>(m_Width - left - right, 1);
+
+    qreal y = fmt.topMargin();
+    qreal naturalWidth = 0;
+
+    tl->beginLayout();
+    for(bool first = true;; first = false) {
+        QTextLine line = tl->createLine();
+        if(!line.isValid())
+            break;
+
+        qreal indent = first ? fmt.textIndent() : 0;
+        line.setLineWidth(lineWidth - indent);
+        line.setPosition({left + indent, y});
+
+        y += line.height();
+        naturalWidth = std::max(naturalWidth, left + indent + line.naturalTextWidth() + right);
+    }
+    tl->endLayout();
+
+    st.height = y + fmt.bottomMargin();
+    st.width = m_Width;
+    st.naturalWidth = naturalWidth;
+    /* the last line is never justified, so a paragraph of one line only moves if it is centred or on the right */
+    st.singleLeftLine = tl->lineCount() == 1 && !(fmt.alignment() & (Qt::AlignHCenter | Qt::AlignRight));
+
+    st.glyphsCached = false;
+    st.spans.clear();
+}
+
+void Glk::TextBufferLayout::reflow(qreal width) {
+    m_Width = width;
+
+    for(QTextBlock block = document()->begin(); block.isValid(); block = block.next()) {
+        auto st = static_cast<BlockState*>(block.userData());
+
+        /* a left aligned single line paragraph that still fits looks exactly the same at the new width */
+        if(st && st->width >= 0 && st->singleLeftLine && st->naturalWidth <= width)
+            st->width = width;
+    }
+
+    m_ValidTops = 0;
+    m_PendingBlock = 0;
+    m_LayoutTimer.start();
+}
+
+void Glk::TextBufferLayout::updateTops(int upTo) const {
+    int count = document()->blockCount();
+    upTo = std::min(upTo, count);
+
+    if(m_Tops.size() != size_t(count) + 1) {
+        m_Tops.resize(size_t(count) + 1);
+        m_ValidTops = std::min(m_ValidTops, count + 1);
+    }
+
+    if(m_ValidTops == 0) {
+        m_Tops[0] = m_Margin;
+        m_ValidTops = 1;
+    }
+
+    if(m_ValidTops > upTo)
+        return;
+
+    QTextBlock block = document()->findBlockByNumber(m_ValidTops - 1);
+    for(int ii = m_ValidTops - 1; ii < upTo && block.isValid(); ii++, block = block.next()) {
+        BlockState& st = state(block);
+
+        /* blocks waiting on a reflow stand in with their old height */
+        if(st.width < 0)
+            layoutBlock(block);
+
+        m_Tops[ii + 1] = m_Tops[ii] + st.height;
+    }
+
+    m_ValidTops = upTo + 1;
+}
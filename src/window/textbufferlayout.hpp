@@ -0,0 +1,114 @@
+#ifndef TEXTBUFFERLAYOUT_HPP
+#define TEXTBUFFERLAYOUT_HPP
+
+#include <vector>
+
+#include <QAbstractTextDocumentLayout>
+#include <QFont>
+#include <QImage>
+#include <QTextFormat>
+#include <QTextObjectInterface>
+#include <QTextOption>
+#include <QTimer>
+
+namespace Glk {
+    /// Sizes and draws the images in a document laid out by TextBufferLayout, straight from the document's
+    ///   resource cache.
+    class TextBufferImageHandler : public QObject, public QTextObjectInterface {
+        Q_OBJECT
+        Q_INTERFACES(QTextObjectInterface)
+
+        public:
+            explicit TextBufferImageHandler(QObject* parent);
+
+
+            QSizeF intrinsicSize(QTextDocument* doc, int posInDocument, const QTextFormat& format) override;
+
+            void drawObject(QPainter* painter, const QRectF& rect, QTextDocument* doc, int posInDocument,
+                            const QTextFormat& format) override;
+
+        private:
+            [[nodiscard]] static QImage image(QTextDocument* doc, const QTextImageFormat& format);
+    };
+
+    /// Document layout for text buffers, used instead of the one QTextDocument brings along when QGLK_TEXT_LAYOUT
+    ///   is set to "fast" at startup. Only builds configured with ENABLE_FAST_TEXT_LAYOUT look at the variable.
+    ///   It only knows what a text buffer needs: a flat list of paragraphs with inline images. Every paragraph is
+    ///   laid out on its own and keeps its height, so output appended to the end only lays out the new paragraphs.
+    ///   When the width changes, paragraphs the change cannot affect are kept as they are. The rest are reflowed
+    ///   once they come into view, or in the background. Each paragraph's glyph runs are cached for painting, and
+    ///   only the paragraphs in the exposed area are drawn. Margin images are inserted inline
+    ///   while it is selected, so the document never holds a frame besides the root one.
+    class TextBufferLayout : public QAbstractTextDocumentLayout {
+            Q_OBJECT
+
+            static constexpr qreal UNBOUNDED_WIDTH = 0x01000000;
+            static constexpr int BACKGROUND_BATCH = 200;
+
+            class BlockState;
+
+        public:
+            explicit TextBufferLayout(QTextDocument* doc);
+
+
+            /// Whether text buffers were set up to use this layout at startup.
+            [[nodiscard]] static bool isSelected();
+
+
+            void draw(QPainter* painter, const PaintContext& context) override;
+
+            [[nodiscard]] int hitTest(const QPointF& point, Qt::HitTestAccuracy accuracy) const override;
+
+            [[nodiscard]] int pageCount() const override;
+
+            [[nodiscard]] QSizeF documentSize() const override;
+
+            [[nodiscard]] QRectF frameBoundingRect(QTextFrame* frame) const override;
+
+            [[nodiscard]] QRectF blockBoundingRect(const QTextBlock& block) const override;
+
+        protected:
+            void documentChanged(int from, int charsRemoved, int charsAdded) override;
+
+            void resizeInlineObject(QTextInlineObject item, int posInDocument, const QTextFormat& format) override;
+
+        private slots:
+            void layoutPending();
+
+        private:
+            [[nodiscard]] static BlockState& state(const QTextBlock& block);
+
+            [[nodiscard]] QTextBlock blockAt(qreal y) const;
+
+            void cacheGlyphs(const QTextBlock& block, BlockState& st) const;
+
+            void drawBlock(QPainter* painter, const PaintContext& context, const QTextBlock& block, qreal top);
+
+            void ensureLaidOut(const QTextBlock& block) const;
+
+            [[nodiscard]] bool layoutParametersChanged();
+
+            void layoutBlock(const QTextBlock& block) const;
+
+            void reflow(qreal width);
+
+            /// Makes sure the tops of the first upTo + 1 entries are known, laying out blocks never laid out before.
+            void updateTops(int upTo) const;
+
+
+            qreal m_Width;
+            QFont m_Font;
+            QTextOption m_TextOption;
+            qreal m_Margin;
+
+            /* m_Tops[ii] is the top of block ii, with the bottom of the last block at the end */
+            mutable std::vector<qreal> m_Tops;
+            mutable int m_ValidTops;
+
+            mutable QTimer m_LayoutTimer;
+            mutable bool m_SizeChanged;
+            int m_PendingBlock; /* where the background reflow carries on from */
+    };
+}
+
+#endif //TEXTBUFFERLAYOUT_HPP
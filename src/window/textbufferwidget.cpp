@@ -1,13 +1,19 @@
 #include "textbufferwidget.hpp"
 
+#include <QAbstractTextDocumentLayout>
 #include <QGridLayout>
 #include <QKeyEvent>
+#include <QScrollBar>
+#include <QTextBlock>
+#include <QTimer>
 
 #include "log/log.hpp"
 #include "thread/taskrequest.hpp"
 
 #include "qglk.hpp"
 
+#include "textbufferlayout.hpp"
+
 Glk::TextBufferBrowser::History::History()
         : m_History{} {}
 
@@ -33,6 +39,18 @@ Glk::TextBufferBrowser::TextBufferBrowser(Glk::TextBufferWidget* wParent)
             this, &TextBufferBrowser::onCursorPositionChanged);
     connect(this, &TextBufferBrowser::cursorPositionChanged,
             this, &TextBufferBrowser::onCursorPositionChanged);
+
+    /* archived blocks come back one page at a time as the reader reaches the top */
+    connect(verticalScrollBar(), &QScrollBar::valueChanged, [this](int value) {
+        if(value == verticalScrollBar()->minimum() && !m_Scrollback.isEmpty())
+            QTimer::singleShot(0, this, &TextBufferBrowser::restoreScrollback);
+    });
+
+    /* the undo stack would otherwise hold on to everything ever trimmed */
+    document()->setUndoRedoEnabled(false);
+
+    if(TextBufferLayout::isSelected())
+        document()->setDocumentLayout(new TextBufferLayout{document()});
 }
 
 QString Glk::TextBufferBrowser::lineInputBuffer() const {
@@ -62,6 +80,53 @@ QVariant Glk::TextBufferBrowser::loadResource(int type, const QUrl& name) {
     return QTextBrowser::loadResource(type, name);
 }
 
+void Glk::TextBufferBrowser::trimScrollback() {
+    QTextDocument* doc = document();
+
+    /* trimming in batches of a quarter of the limit keeps the pages reasonably sized */
+    int limit = m_Scrollback.liveBlockLimit();
+    if(limit == 0 || doc->blockCount() <= limit + limit / 4)
+        return;
+
+    int count = doc->blockCount() - limit;
+    QTextBlock boundary = doc->findBlockByNumber(count);
+
+    /* leave the document alone while the reader is looking at what would be trimmed */
+    if(cursorForPosition(QPoint{0, 0}).position() < boundary.position())
+        return;
+
+    int removedChars = boundary.position();
+    int removedHeight = int(doc->documentLayout()->blockBoundingRect(boundary).top());
+
+    m_Scrollback.archive(*doc, count);
+
+    QTextCursor cur{doc};
+    cur.setPosition(removedChars, QTextCursor::KeepAnchor);
+    cur.removeSelectedText();
+
+    if(receivingLineInput())
+        m_LineInputStartCursorPosition -= removedChars;
+
+    verticalScrollBar()->setValue(verticalScrollBar()->value() - removedHeight);
+}
+
+void Glk::TextBufferBrowser::restoreScrollback() {
+    if(m_Scrollback.isEmpty() || verticalScrollBar()->value() != verticalScrollBar()->minimum())
+        return;
+
+    QTextDocument* doc = document();
+    int oldLength = doc->characterCount();
+
+    int blocks = m_Scrollback.restore(*doc);
+
+    if(receivingLineInput())
+        m_LineInputStartCursorPosition += doc->characterCount() - oldLength;
+
+    /* keep what the reader was looking at in place, with the restored page above it */
+    int addedHeight = int(doc->documentLayout()->blockBoundingRect(doc->findBlockByNumber(blocks)).top());
+    verticalScrollBar()->setValue(verticalScrollBar()->value() + addedHeight);
+}
+
 void Glk::TextBufferBrowser::pushInputStyle() {
     setCurrentCharFormat(inputCharFormat());
 }
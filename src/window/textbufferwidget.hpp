@@ -7,6 +7,7 @@
 #include <QImage>
 #include <QTextBrowser>
 
+#include "scrollbackarchive.hpp"
 #include "windowwidget.hpp"
 
 namespace Glk {
@@ -82,9 +83,18 @@ namespace Glk {
                 return m_LineInputStartCursorPosition >= 0;
             }
 
+            [[nodiscard]] inline ScrollbackArchive& scrollback() {
+                return m_Scrollback;
+            }
+
+            /// Moves the oldest blocks into the scrollback archive once the document is over its block limit.
+            void trimScrollback();
+
         public slots:
             void onCursorPositionChanged();
 
+            void restoreScrollback();
+
         protected:
             void keyPressEvent(QKeyEvent* ev) override;
 
@@ -98,6 +108,8 @@ namespace Glk {
 
             History m_History;
             History::Iterator m_HistoryIterator;
+
+            ScrollbackArchive m_Scrollback;
     };
 
     class TextBufferWidget : public WindowWidget {
@@ -40,30 +40,7 @@ void Glk::TextBufferWindow::clearWindow() {
 bool Glk::TextBufferWindow::drawImage(glui32 img, glsi32 param1, glsi32 param2, QSize size) {
     assert(onGlkThread());
 
-    std::string_view style;
-    switch(param1) {
-        case imagealign_InlineUp:
-            style = "vertical-align: top";
-            break;
-
-        case imagealign_InlineCenter:
-            style = "vertical-align: middle";
-            break;
-
-        case imagealign_InlineDown:
-            style = "vertical-align: bottom";
-            break;
-
-        case imagealign_MarginLeft:
-            style = "float: left";
-            break;
-
-        case imagealign_MarginRight:
-            style = "float: right";
-            break;
-    }
-
-    controller<TextBufferWindowController>()->pushCommand(TextBufferCommand::WriteImage{img, size, style});
+    controller<TextBufferWindowController>()->pushCommand(TextBufferCommand::WriteImage{img, size, glui32(param1)});
 
     return true;
 }
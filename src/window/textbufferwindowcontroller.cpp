@@ -1,15 +1,43 @@
 #include "textbufferwindowcontroller.hpp"
 
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <utility>
+
+#include <QImage>
+#include <QRunnable>
 #include <QSemaphore>
+#include <QTextCursor>
+#include <QTextDocument>
+#include <QTextImageFormat>
 #include <QThread>
 
 #include "qglk.hpp"
 #include "log/log.hpp"
 #include "thread/taskrequest.hpp"
 
+#include "textbufferlayout.hpp"
 #include "textbufferwidget.hpp"
 #include "textbufferwindow.hpp"
 
+namespace {
+    template<class F>
+    class TaskRunnable : public QRunnable {
+        public:
+            explicit TaskRunnable(F task) : m_Task{std::move(task)} {}
+
+            void run() override {
+                m_Task();
+            }
+
+        private:
+            F m_Task;
+    };
+}
+
 Glk::TextBufferWindowController::TextBufferWindowController(Glk::PairWindow* winParent, glui32 winRock)
     : WindowController(new TextBufferWindow(this, winParent, winRock), createWidget()) {
     QObject::connect(keyboardProvider(), &KeyboardInputProvider::notifyLineInputRequestCancelled,
@@ -45,15 +73,26 @@ Glk::TextBufferWindowController::TextBufferWindowController(Glk::PairWindow* win
 
 Glk::TextBufferWindowController::~TextBufferWindowController() = default;
 
+void Glk::TextBufferWindowController::prepareSynchronization() {
+    assert(onEventThread());
+
+    if(m_HasCommands && canSynchronizeText())
+        startBuild();
+}
+
 void Glk::TextBufferWindowController::synchronize() {
     assert(onEventThread());
 
-    if(!keyboardProvider()->lineInputRequest() || !keyboardProvider()->lineInputRequest()->isPending()) {
-        synchronizeText();
+    if(canSynchronizeText()) {
+        if(m_HasCommands)
+            startBuild();
+
         synchronizeInputStyle();
     }
 
-    WindowController::synchronize();
+    /* with builds still running the window is only synchronized once they are spliced in */
+    if(m_PendingBuilds.empty())
+        WindowController::synchronize();
 }
 
 QPoint Glk::TextBufferWindowController::glkPos(const QPoint& qtPos) const {
@@ -62,7 +101,7 @@ QPoint Glk::TextBufferWindowController::glkPos(const QPoint& qtPos) const {
     return qtPos;
 }
 
-QSize Glk::TextBufferWindowController::glkSize() const {
+QSize Glk::TextBufferWindowController::computeGlkSize() const {
     QRect widgetBrowserFrameRect = widget<TextBufferWidget>()->browser()->frameRect();
     return {widgetBrowserFrameRect.width() / widget()->fontMetrics().horizontalAdvance('m'),
             widgetBrowserFrameRect.height() / widget()->fontMetrics().height()};
@@ -89,25 +128,27 @@ bool Glk::TextBufferWindowController::supportsLineInput() const {
 }
 
 void Glk::TextBufferWindowController::pushCommand(Glk::TextBufferWindowController::Command cmd) {
+    m_HasCommands = true;
+
     std::visit([this](auto&& c) {
         using T = std::decay_t<decltype(c)>;
 
-        if constexpr(std::is_same_v<T, TextBufferCommand::WriteText>) {
+        if constexpr(std::is_same_v<T, TextBufferCommand::HyperlinkPush> ||
+                     std::is_same_v<T, TextBufferCommand::StylePush> ||
+                     std::is_same_v<T, TextBufferCommand::WriteText>) {
             if(!m_Commands.empty()) {
-                auto merged = std::visit([&c](auto&& b) -> bool {
-                    using U = std::decay_t<decltype(b)>;
-
-                    if constexpr(std::is_same_v<U, TextBufferCommand::WriteText>) {
+                if(auto b = std::get_if<T>(&m_Commands.back())) {
+                    if constexpr(std::is_same_v<T, TextBufferCommand::WriteText>) {
                         /* merge two consecutive WriteText commands together */
-                        b.text.append(c.text);
-                        return true;
+                        appendText(b->text, c.text);
                     } else {
-                        return false;
+                        /* only the last of a run of pushes has any effect */
+                        *b = std::move(c);
                     }
-                }, m_Commands.back());
 
-                if(merged)
+                    m_FoldedCommands++;
                     return;
+                }
             }
         }
 
@@ -117,35 +158,28 @@ void Glk::TextBufferWindowController::pushCommand(Glk::TextBufferWindowControlle
     requestSynchronization();
 }
 
-QWidget* Glk::TextBufferWindowController::createWidget() {
-    QWidget* w = nullptr;
+void Glk::TextBufferWindowController::appendText(QString& text, const QString& tail) {
+    int size = text.size() + tail.size();
+    if(text.capacity() < size)
+        text.reserve(std::max(size, 2 * text.size()));
 
-    Glk::sendTaskToEventThread([&w]() {
-        w = new TextBufferWidget;
-        w->hide();
-    });
-
-    return w;
+    text.append(tail);
 }
 
-void Glk::TextBufferWindowController::synchronizeInputStyle() {
-    Style inputStyle = window<TextBufferWindow>()->styles()[Style::Input];
+Glk::TextBufferWindowController::Build Glk::TextBufferWindowController::build(std::vector<Command> commands, Style style) {
+    Build result;
+    glui32 link = 0;
 
-    widget<TextBufferWidget>()->browser()->setInputBlockFormat(inputStyle.blockFormat());
-    widget<TextBufferWidget>()->browser()->setInputCharFormat(inputStyle.charFormat());
-}
+    /* the commands come out of optimize(), which leaves at most one Clear and puts it first */
+    result.clear = !commands.empty() && std::holds_alternative<TextBufferCommand::Clear>(commands.front());
 
-void Glk::TextBufferWindowController::synchronizeText() {
-    QTextDocument& doc = *widget<TextBufferWidget>()->browser()->document();
+    QTextDocument doc;
     QTextCursor cur{&doc};
+    cur.beginEditBlock();
 
-    glui32 link = 0;
-    Style style = window<TextBufferWindow>()->styles()[Style::Type::Normal];
-    QTextCharFormat charFormat = style.charFormat();
-
-    auto fn_push_link = [&cur, &link, &style, &charFormat](glui32 newLink) {
+    auto fn_push_link = [&cur, &style, &link](glui32 newLink) {
         link = newLink;
-        charFormat = style.charFormat();
+        QTextCharFormat charFormat = style.charFormat();
 
         if(link != 0) {
             charFormat.setAnchor(true);
@@ -156,21 +190,19 @@ void Glk::TextBufferWindowController::synchronizeText() {
 
         cur.setCharFormat(charFormat);
     };
-    auto fn_push_style = [&cur, &link, &style, &fn_push_link](Style newStyle) {
+    auto fn_push_style = [&cur, &style, &link, &fn_push_link](Style newStyle) {
         style = std::move(newStyle);
         cur.setBlockFormat(style.blockFormat());
         fn_push_link(link);
     };
 
-    cur.movePosition(QTextCursor::End);
-    for(const auto& cmd : m_Commands) {
-        std::visit([&doc, &cur, &fn_push_link, &fn_push_style](auto&& cmd) {
+    if(result.clear)
+        fn_push_style(style);
+
+    for(auto& command : commands) {
+        std::visit([&cur, &fn_push_link, &fn_push_style](auto&& cmd) {
             using T = std::decay_t<decltype(cmd)>;
 
-            if constexpr(std::is_same_v<T, TextBufferCommand::Clear>) {
-                doc.clear();
-                cur.movePosition(QTextCursor::Start);
-            }
             if constexpr(std::is_same_v<T, TextBufferCommand::FlowBreak>) {
                 cur.insertBlock();
             }
@@ -181,27 +213,292 @@ void Glk::TextBufferWindowController::synchronizeText() {
                 fn_push_style(std::move(cmd.style));
             }
             if constexpr(std::is_same_v<T, TextBufferCommand::WriteImage>) {
-                std::string_view fmtStr;
-                if(cmd.size.isEmpty())
-                    fmtStr = "<img src=\"{0}\" alt=\"Image #{0}\" style=\"{3}\" />";
-                else
-                    fmtStr = "<img src=\"{0}\" alt=\"Image #{0}\" width=\"{1}\" height=\"{2}\" style=\"{3}\" />";
-
-                QString imgHtml;
-                fmt::format_to(std::back_inserter(imgHtml), fmtStr,
-                               cmd.image, cmd.size.width(), cmd.size.height(), cmd.style);
-
-                cur.insertHtml(imgHtml);
+                insertImage(cur, cmd);
             }
             if constexpr(std::is_same_v<T, TextBufferCommand::WriteText>) {
                 cur.insertText(cmd.text);
             }
-        }, cmd);
+        }, command);
     }
 
+    cur.endEditBlock();
+
+    /* the first block is merged into the block the fragment lands in, so its format has to be carried separately */
+    result.blockFormat = doc.begin().blockFormat();
+    result.fragment = QTextDocumentFragment{&doc};
+
+    return result;
+}
+
+std::vector<Glk::TextBufferWindowController::Command> Glk::TextBufferWindowController::takeCommands() {
+    std::vector<Command> commands;
+    commands.reserve(m_Commands.size() + 2);
+
+    /* builds do not wait for each other, so each starts from the style and hyperlink the one before ended with */
+    if(m_CarriedStyle) {
+        commands.emplace_back(TextBufferCommand::StylePush{*m_CarriedStyle});
+        commands.emplace_back(TextBufferCommand::HyperlinkPush{m_CarriedLink});
+    }
+
+    std::move(m_Commands.begin(), m_Commands.end(), std::back_inserter(commands));
     m_Commands.clear();
+    m_HasCommands = false;
+
+    size_t pushed = commands.size() + m_FoldedCommands;
+    commands = optimize(std::move(commands));
+
+    size_t eliminated = pushed - commands.size();
+    m_EliminatedCommands += eliminated;
+    m_FoldedCommands = 0;
+
+    SPDLOG_TRACE("Synchronizing {} text commands for window {} ({} eliminated, {} in total)",
+                 commands.size(), wrap::ptr(window()), eliminated, m_EliminatedCommands);
+
+    for(auto& cmd : commands) {
+        if(auto stylePush = std::get_if<TextBufferCommand::StylePush>(&cmd))
+            m_CarriedStyle = stylePush->style;
+        else if(auto linkPush = std::get_if<TextBufferCommand::HyperlinkPush>(&cmd))
+            m_CarriedLink = linkPush->link;
+        else if(auto writeImage = std::get_if<TextBufferCommand::WriteImage>(&cmd))
+            writeImage->loaded = QGlk::getMainWindow().loadImage(writeImage->image);
+    }
+
+    if(!m_CarriedStyle)
+        m_CarriedStyle = window<TextBufferWindow>()->styles()[Style::Type::Normal];
+
+    return commands;
+}
+
+std::vector<Glk::TextBufferWindowController::Command> Glk::TextBufferWindowController::optimize(std::vector<Command> commands) {
+    std::vector<Command> optimized;
+    optimized.reserve(commands.size());
+
+    /* style and hyperlink changes are only written out once something is output with them, so runs of
+     * them fold into one and changes that end up where they started let the surrounding text merge */
+    std::optional<Style> pendingStyle, currentStyle;
+    std::optional<glui32> pendingLink, currentLink;
+
+    /* nothing written before the last Clear survives it, only the style and hyperlink in effect do */
+    auto itClear = std::find_if(commands.rbegin(), commands.rend(), [](const Command& cmd) {
+        return std::holds_alternative<TextBufferCommand::Clear>(cmd);
+    });
+    auto itFirst = itClear.base();
+    if(itClear != commands.rend()) {
+        optimized.emplace_back(TextBufferCommand::Clear{});
+
+        for(auto it = commands.begin(); it != itFirst; ++it) {
+            if(auto stylePush = std::get_if<TextBufferCommand::StylePush>(&*it))
+                pendingStyle = std::move(stylePush->style);
+            else if(auto linkPush = std::get_if<TextBufferCommand::HyperlinkPush>(&*it))
+                pendingLink = linkPush->link;
+        }
+    }
+
+    size_t textIndex = std::numeric_limits<size_t>::max();
+
+    auto fn_flush_state = [&]() {
+        if(pendingStyle && (!currentStyle || *pendingStyle != *currentStyle)) {
+            optimized.emplace_back(TextBufferCommand::StylePush{*pendingStyle});
+            currentStyle = std::move(pendingStyle);
+            textIndex = std::numeric_limits<size_t>::max();
+        }
+
+        if(pendingLink && (!currentLink || *pendingLink != *currentLink)) {
+            optimized.emplace_back(TextBufferCommand::HyperlinkPush{*pendingLink});
+            currentLink = pendingLink;
+            textIndex = std::numeric_limits<size_t>::max();
+        }
+
+        pendingStyle.reset();
+        pendingLink.reset();
+    };
+
+    for(auto it = itFirst; it != commands.end(); ++it) {
+        std::visit([&](auto&& c) {
+            using T = std::decay_t<decltype(c)>;
+
+            if constexpr(std::is_same_v<T, TextBufferCommand::HyperlinkPush>) {
+                pendingLink = c.link;
+            }
+            if constexpr(std::is_same_v<T, TextBufferCommand::StylePush>) {
+                pendingStyle = std::move(c.style);
+            }
+            if constexpr(std::is_same_v<T, TextBufferCommand::FlowBreak> ||
+                         std::is_same_v<T, TextBufferCommand::WriteImage>) {
+                fn_flush_state();
+                optimized.emplace_back(std::move(c));
+                textIndex = std::numeric_limits<size_t>::max();
+            }
+            if constexpr(std::is_same_v<T, TextBufferCommand::WriteText>) {
+                if(c.text.isEmpty())
+                    return;
+
+                fn_flush_state();
+                if(textIndex < optimized.size()) {
+                    appendText(std::get<TextBufferCommand::WriteText>(optimized[textIndex]).text, c.text);
+                } else {
+                    textIndex = optimized.size();
+                    optimized.emplace_back(std::move(c));
+                }
+            }
+        }, *it);
+    }
+
+    /* trailing changes carry over to whatever is written next */
+    fn_flush_state();
+
+    return optimized;
+}
+
+void Glk::TextBufferWindowController::insertImage(QTextCursor& cur, const TextBufferCommand::WriteImage& cmd) {
+    QString name = QString::number(cmd.image);
+
+    /* the image goes into the resource cache up front, so the browser never has to ask for it by name; it
+     * travels with the fragment and is only taken over by the window's document if it has not got it yet */
+    if(cmd.loaded.isNull()) {
+        spdlog::warn("Failed to load image {} for text buffer", cmd.image);
+        return;
+    }
+
+    cur.document()->addResource(QTextDocument::ImageResource, QUrl{name}, cmd.loaded);
+
+    QTextImageFormat fmt;
+    fmt.merge(cur.charFormat()); /* keeps any hyperlink on the image */
+    fmt.setName(name);
+    if(cmd.size.isValid()) {
+        fmt.setWidth(cmd.size.width());
+        fmt.setHeight(cmd.size.height());
+    }
+
+    /* the fast layout has no floats and draws margin images inline, so they get no frame of their own there */
+    switch(cmd.alignment) {
+        case imagealign_MarginLeft:
+            if(TextBufferLayout::isSelected())
+                break;
+
+            cur.insertImage(fmt, QTextFrameFormat::FloatLeft);
+            return;
+
+        case imagealign_MarginRight:
+            if(TextBufferLayout::isSelected())
+                break;
+
+            cur.insertImage(fmt, QTextFrameFormat::FloatRight);
+            return;
 
-    /* store current style and hyperlink for next time */
-    m_Commands.emplace_back(TextBufferCommand::StylePush{std::move(style)});
-    m_Commands.emplace_back(TextBufferCommand::HyperlinkPush{link});
+        case imagealign_InlineUp:
+            fmt.setVerticalAlignment(QTextCharFormat::AlignTop);
+            break;
+
+        case imagealign_InlineCenter:
+            fmt.setVerticalAlignment(QTextCharFormat::AlignMiddle);
+            break;
+
+        case imagealign_InlineDown:
+            fmt.setVerticalAlignment(QTextCharFormat::AlignBottom);
+            break;
+    }
+
+    cur.insertImage(fmt);
+}
+
+bool Glk::TextBufferWindowController::canSynchronizeText() const {
+    return !keyboardProvider()->lineInputRequest() || !keyboardProvider()->lineInputRequest()->isPending();
+}
+
+QWidget* Glk::TextBufferWindowController::createWidget() {
+    QWidget* w = nullptr;
+
+    Glk::sendTaskToEventThread([&w]() {
+        w = new TextBufferWidget;
+        w->hide();
+    });
+
+    return w;
+}
+
+void Glk::TextBufferWindowController::synchronizeInputStyle() {
+    Style inputStyle = window<TextBufferWindow>()->styles()[Style::Input];
+
+    widget<TextBufferWidget>()->browser()->setInputBlockFormat(inputStyle.blockFormat());
+    widget<TextBufferWidget>()->browser()->setInputCharFormat(inputStyle.charFormat());
+}
+
+void Glk::TextBufferWindowController::startBuild() {
+    auto pending = std::make_shared<std::optional<Build>>();
+    m_PendingBuilds.push_back(pending);
+
+    auto task = [this, pending = std::weak_ptr{pending}, commands = takeCommands(),
+                 style = window<TextBufferWindow>()->styles()[Style::Type::Normal]]() mutable {
+        Build result = build(std::move(commands), std::move(style));
+
+        /* a window closed in the meantime has dropped its pending builds, and with them this one */
+        Glk::postTaskToEventThread([this, pending, result]() {
+            if(auto p = pending.lock()) {
+                *p = result;
+                spliceBuilds();
+            }
+        });
+    };
+
+    QGlk::getMainWindow().documentBuildPool().start(new TaskRunnable{std::move(task)});
+}
+
+void Glk::TextBufferWindowController::spliceBuilds() {
+    assert(onEventThread());
+
+    /* builds can finish out of order, but have to go into the document in the order they were started */
+    while(!m_PendingBuilds.empty() && m_PendingBuilds.front()->has_value()) {
+        splice(**m_PendingBuilds.front());
+        m_PendingBuilds.pop_front();
+    }
+
+    if(!m_PendingBuilds.empty())
+        return;
+
+    WindowController::synchronize();
+
+    /* whatever was written while the builds ran is taken the next time the glk thread stops */
+    if(m_HasCommands && canSynchronizeText())
+        requestSynchronization();
+}
+
+void Glk::TextBufferWindowController::splice(const Build& result) {
+    TextBufferBrowser* browser = widget<TextBufferWidget>()->browser();
+    QTextDocument& doc = *browser->document();
+
+    /* line input can have been requested while the build ran, the output then goes in ahead of it */
+    int inputStart = browser->receivingLineInput() ? browser->lineInputStartCursorPosition() : -1;
+
+    if(result.clear) {
+        browser->scrollback().clear();
+
+        if(inputStart < 0) {
+            doc.clear();
+        } else {
+            browser->setLineInputStartCursorPosition(0);
+
+            QTextCursor cur{&doc};
+            cur.setPosition(inputStart, QTextCursor::KeepAnchor);
+            cur.removeSelectedText();
+            inputStart = 0;
+        }
+    }
+
+    int length = doc.characterCount();
+
+    QTextCursor cur{&doc};
+    cur.beginEditBlock();
+    if(inputStart < 0)
+        cur.movePosition(QTextCursor::End);
+    else
+        cur.setPosition(inputStart);
+    cur.setBlockFormat(result.blockFormat);
+    cur.insertFragment(result.fragment);
+    cur.endEditBlock();
+
+    if(inputStart >= 0)
+        browser->setLineInputStartCursorPosition(inputStart + doc.characterCount() - length);
+
+    browser->trimScrollback();
 }
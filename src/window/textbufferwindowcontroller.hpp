@@ -1,15 +1,20 @@
 #ifndef TEXTBUFFERWINDOWCONTROLLER_HPP
 #define TEXTBUFFERWINDOWCONTROLLER_HPP
 
-#include <string_view>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <optional>
 #include <variant>
 #include <vector>
 
+#include <QImage>
+#include <QTextBlockFormat>
+#include <QTextDocumentFragment>
+
 #include "style.hpp"
 #include "windowcontroller.hpp"
 
-class QTextBlockFormat;
-
 class QTextCharFormat;
 
 class QTextCursor;
@@ -32,8 +37,9 @@ namespace Glk {
 
         struct WriteImage {
             glui32 image;
-            QSize size;
-            std::string_view style;
+            QSize size; /* invalid for the image's own size */
+            glui32 alignment;
+            QImage loaded{}; /* filled in on the event thread before the build, which must not touch the blorb */
         };
 
         struct WriteText {
@@ -51,17 +57,27 @@ namespace Glk {
                     TextBufferCommand::WriteText
             >;
 
+            /// The outcome of replaying a command list into a scratch document, ready to be spliced into the
+            ///   window's document.
+            struct Build {
+                bool clear{false};
+                QTextBlockFormat blockFormat; /* for the block the fragment is inserted into */
+                QTextDocumentFragment fragment;
+            };
+
         public:
             TextBufferWindowController(PairWindow* winParent, glui32 winRock);
 
             ~TextBufferWindowController() override;
 
 
+            void prepareSynchronization() override;
+
             void synchronize() override;
 
             QPoint glkPos(const QPoint& qtPos) const override;
 
-            [[nodiscard]] QSize glkSize() const override;
+            [[nodiscard]] QSize computeGlkSize() const override;
 
             [[nodiscard]] QSize toQtSize(const QSize& glk) const override;
 
@@ -74,16 +90,56 @@ namespace Glk {
 
             void pushCommand(Command cmd);
 
+            /// Total number of commands dropped or merged away before reaching the document.
+            [[nodiscard]] inline size_t eliminatedCommands() const {
+                return m_EliminatedCommands;
+            }
+
         private:
+            /// Replays a command list from optimize() into a scratch document, starting from style. Touches no
+            ///   window, so it runs on the document build pool.
+            [[nodiscard]] static Build build(std::vector<Command> commands, Style style);
+
+            /// Rewrites a command list into the shortest list that produces the same output. Drops everything before
+            ///   the last Clear except the style and hyperlink in effect, folds runs of style and hyperlink pushes and
+            ///   merges text written across style changes that turn out to change nothing.
+            [[nodiscard]] static std::vector<Command> optimize(std::vector<Command> commands);
+
             [[nodiscard]] static QWidget* createWidget();
 
 
-            void synchronizeInputStyle();
+            static void appendText(QString& text, const QString& tail);
 
-            void synchronizeText();
+            /// Inserts the image as an image format, floated into the margin for the margin alignments.
+            static void insertImage(QTextCursor& cur, const TextBufferCommand::WriteImage& cmd);
+
+            [[nodiscard]] bool canSynchronizeText() const;
+
+            /// Optimizes and hands over the pending commands, logging how many were eliminated since last time. Images
+            ///   are loaded here, on the event thread, so builds on the pool never read the blorb file.
+            [[nodiscard]] std::vector<Command> takeCommands();
+
+
+            /// Takes the pending commands and builds them on the document build pool. Returns straight away, the
+            ///   result is spliced in by spliceBuilds() once it is ready.
+            void startBuild();
+
+            /// Splices every finished build into the document that no earlier build is still holding up, and marks
+            ///   the window synchronized once none are left.
+            void spliceBuilds();
+
+            void splice(const Build& result);
+
+            void synchronizeInputStyle();
 
 
             std::vector<Command> m_Commands;
+            std::atomic_bool m_HasCommands{false}; /* set on the glk thread by every push */
+            std::deque<std::shared_ptr<std::optional<Build>>> m_PendingBuilds; /* in the order they were started */
+            std::optional<Style> m_CarriedStyle; /* the style and hyperlink the last build taken ends with */
+            glui32 m_CarriedLink{0};
+            size_t m_FoldedCommands{0}; /* merged into the previous command as they were pushed */
+            size_t m_EliminatedCommands{0};
     };
 }
 
@@ -0,0 +1,46 @@
+#ifndef TEXTGRIDCELL_HPP
+#define TEXTGRIDCELL_HPP
+
+#include "glk.hpp"
+
+#include "style.hpp"
+
+namespace Glk {
+    /// One cell of a text grid packed into a single word: the code point in the low 24 bits and the style it was
+    ///   written in above them. Grids store their cells as one flat row-major array of these.
+    class TextGridCell {
+            static constexpr glui32 CHARACTER_MASK = 0x00ffffff;
+            static constexpr int STYLE_SHIFT = 24;
+            static constexpr glui32 REPLACEMENT_CHARACTER = 0xfffd;
+
+        public:
+            constexpr TextGridCell()
+                : m_Value{' '} {}
+
+            constexpr TextGridCell(glui32 ch, Style::Type style)
+                : m_Value{(ch > 0x10ffff ? REPLACEMENT_CHARACTER : ch) | (glui32(style) << STYLE_SHIFT)} {}
+
+            [[nodiscard]] inline constexpr char32_t character() const {
+                return char32_t(m_Value & CHARACTER_MASK);
+            }
+
+            [[nodiscard]] inline constexpr Style::Type style() const {
+                return Style::Type(m_Value >> STYLE_SHIFT);
+            }
+
+            [[nodiscard]] inline constexpr bool operator==(TextGridCell other) const {
+                return m_Value == other.m_Value;
+            }
+
+            [[nodiscard]] inline constexpr bool operator!=(TextGridCell other) const {
+                return m_Value != other.m_Value;
+            }
+
+        private:
+            glui32 m_Value;
+    };
+
+    static_assert(sizeof(TextGridCell) == sizeof(glui32));
+}
+
+#endif //TEXTGRIDCELL_HPP
@@ -1,48 +1,103 @@
 #include "textgridwidget.hpp"
 
-#include <memory>
+#include <algorithm>
+#include <array>
 
-#include <QDebug>
 #include <QFontDatabase>
-#include <QGridLayout>
 #include <QPainter>
 #include <QPaintEvent>
 
-Glk::TextGridWidget::TextGridWidget()
-    : WindowWidget{}, mp_Label{} {
-    QGridLayout* lay = new QGridLayout(this);
-    lay->setMargin(0);
+#include "glyphatlas.hpp"
 
-    mp_Label = new QLabel(this);
-    mp_Label->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
-    mp_Label->setTextFormat(Qt::PlainText);
-    mp_Label->setAlignment(Qt::AlignCenter);
-
-    lay->addWidget(mp_Label);
+Glk::TextGridWidget::TextGridWidget(const StyleManager& styles)
+    : WindowWidget{}, m_Styles{styles}, m_Cells{TextGridCell{}}, m_GridSize{1, 1} {
+    setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
 
+    /* every paint fills what it covers */
+    setAttribute(Qt::WA_OpaquePaintEvent);
 
     setFocusPolicy(Qt::StrongFocus);
 
     installInputFilter(this);
 }
 
-void Glk::TextGridWidget::setGrid(const std::vector<std::vector<glui32>> &newGrid) {
-    QString str;
-    {
-        size_t ii = 0;
-        for(const auto& line : newGrid) {
-            str.append(QString::fromUcs4(line.data(), line.size()));
-            if(ii != newGrid.size()-1)
-                str.append('\n');
-            ++ii;
+void Glk::TextGridWidget::resizeGrid(QSize size) {
+    if(size == m_GridSize)
+        return;
+
+    std::vector<TextGridCell> cells(size_t(size.width()) * size.height());
+
+    int columns = std::min(size.width(), m_GridSize.width());
+    for(int yy = 0; yy < std::min(size.height(), m_GridSize.height()); yy++)
+        std::copy_n(m_Cells.begin() + yy * m_GridSize.width(), columns, cells.begin() + yy * size.width());
+
+    m_Cells = std::move(cells);
+    m_GridSize = size;
+
+    update();
+}
+
+void Glk::TextGridWidget::setCells(int row, int column, const TextGridCell* cells, int count) {
+    assert(row >= 0 && row < m_GridSize.height());
+    assert(column >= 0 && column + count <= m_GridSize.width());
+
+    std::copy_n(cells, count, m_Cells.begin() + row * m_GridSize.width() + column);
+
+    update(cellRect(row, column, count));
+}
+
+int Glk::TextGridWidget::charHeight() const {
+    return atlas().cellSize().height();
+}
+
+int Glk::TextGridWidget::charWidth() const {
+    return atlas().cellSize().width();
+}
+
+void Glk::TextGridWidget::paintEvent(QPaintEvent* event) {
+    QPainter painter{this};
+    painter.fillRect(event->rect(), palette().window());
+
+    QSize cell = atlas().cellSize();
+    std::array<GlyphAtlas*, style_NUMSTYLES> atlases{}; /* looked up once per paint */
+    QPoint origin = contentsRect().topLeft();
+
+    QRect area = event->rect().translated(-origin);
+    int firstRow = std::max(0, area.top() / cell.height());
+    int lastRow = std::min(m_GridSize.height() - 1, area.bottom() / cell.height());
+    int firstColumn = std::max(0, area.left() / cell.width());
+    int lastColumn = std::min(m_GridSize.width() - 1, area.right() / cell.width());
+
+    for(int yy = firstRow; yy <= lastRow; yy++) {
+        for(int xx = firstColumn; xx <= lastColumn; xx++) {
+            TextGridCell gridCell = m_Cells[yy * m_GridSize.width() + xx];
+            if(gridCell.character() == ' ')
+                continue;
+
+            GlyphAtlas*& glyphs = atlases[gridCell.style()];
+            if(!glyphs)
+                glyphs = &atlas(gridCell.style());
+
+            QRect source = glyphs->glyph(gridCell.character());
+            QRectF target{QPointF(origin.x() + xx * cell.width(), origin.y() + yy * cell.height()), QSizeF{cell}};
+            painter.drawImage(target, glyphs->image(), QRectF{source});
         }
     }
+}
 
-    mp_Label->setText(str);
+Glk::GlyphAtlas& Glk::TextGridWidget::atlas(Style::Type style) const {
+    const QTextCharFormat& format = m_Styles[style].charFormat();
+
+    QFont styleFont = font();
+    styleFont.setWeight(format.font().weight());
+    styleFont.setItalic(format.font().italic());
+
+    return GlyphAtlas::get(styleFont, format.foreground().color(), devicePixelRatioF());
 }
 
-void Glk::TextGridWidget::resizeEvent(QResizeEvent* event) {
-    QWidget::resizeEvent(event);
+QRect Glk::TextGridWidget::cellRect(int row, int column, int count) const {
+    QSize cell = atlas().cellSize();
 
-    emit resized();
-}
\ No newline at end of file
+    return {contentsRect().left() + column * cell.width(), contentsRect().top() + row * cell.height(),
+            count * cell.width(), cell.height()};
+}
@@ -3,10 +3,12 @@
 
 #include <vector>
 
-#include <QLabel>
+#include <QWidget>
 
 #include "glk.hpp"
 
+#include "stylemanager.hpp"
+#include "textgridcell.hpp"
 #include "windowwidget.hpp"
 
 //#include <fmt/format.h>
@@ -65,37 +67,36 @@
 //}
 
 namespace Glk {
+    class GlyphAtlas;
+
+    /// Paints a text grid cell by cell from glyph atlases, one for each style in use. The widget keeps its own
+    ///   copy of the cells, and only the rows that were changed are repainted.
     class TextGridWidget : public WindowWidget {
         Q_OBJECT
         public:
-            TextGridWidget();
-
-            void setGrid(const std::vector<std::vector<glui32>>& newGrid);
+            explicit TextGridWidget(const StyleManager& styles);
 
-            [[nodiscard]] inline int charHeight() const {
-                return mp_Label->fontMetrics().height();
-            }
+            void resizeGrid(QSize size);
 
-            [[nodiscard]] inline int charWidth() const {
-                return mp_Label->fontMetrics().boundingRect('m').width();
-            }
+            void setCells(int row, int column, const TextGridCell* cells, int count);
 
-//            [[nodiscard]] inline int horizontalMargins() const {
-//                return contentsMargins().left() + contentsMargins().right();
-//            }
-//
-//            [[nodiscard]] inline int verticalMargins() const {
-//                return contentsMargins().top() + contentsMargins().bottom();
-//            }
+            [[nodiscard]] int charHeight() const;
 
-        signals:
-            void resized();
+            [[nodiscard]] int charWidth() const;
 
         protected:
-            void resizeEvent(QResizeEvent* event) override;
+            void paintEvent(QPaintEvent* event) override;
 
         private:
-            QLabel* mp_Label;
+            /// The atlas for a style: the grid's fixed width font with the style's weight, slant and colour.
+            [[nodiscard]] GlyphAtlas& atlas(Style::Type style = Style::Normal) const;
+
+            [[nodiscard]] QRect cellRect(int row, int column, int count) const;
+
+
+            StyleManager m_Styles;
+            std::vector<TextGridCell> m_Cells; /* row major */
+            QSize m_GridSize;
     };
 }
 
@@ -1,6 +1,7 @@
 #include "textgridwindow.hpp"
 
 #include <algorithm>
+#include <utility>
 
 #include <QtEndian>
 
@@ -30,17 +31,18 @@ std::streamsize Glk::TextGridBuf::xsputn(const char* s, std::streamsize count) {
 
 Glk::TextGridWindow::TextGridWindow(Glk::TextGridWindowController* winController, Glk::PairWindow* winParent, glui32 winRock)
     : Window(Type::TextGrid, winController, std::make_unique<TextGridBuf>(this), winParent, winRock),
-      m_CharArray{{EMPTY_CHAR}},
+      m_Cells{TextGridCell{}},
+      m_DirtyRows(1),
       m_GridSize{1, 1},
-      m_Cursor(0, 0) {}
+      m_Cursor(0, 0),
+      m_Style{Style::Normal} {}
 
 void Glk::TextGridWindow::clearWindow() {
-    std::for_each(m_CharArray.begin(), m_CharArray.end(), [](auto& row) {
-        std::fill(row.begin(), row.end(), EMPTY_CHAR);
-    });
+    std::fill(m_Cells.begin(), m_Cells.end(), TextGridCell{});
 
     m_Cursor = {0, 0};
 
+    markAllDirty();
     controller()->requestSynchronization();
 }
 
@@ -48,23 +50,29 @@ void Glk::TextGridWindow::moveCursor(glui32 x, glui32 y) {
     m_Cursor = {std::min<int>(m_GridSize.width() - 1, x), std::min<int>(m_GridSize.height() - 1, y)};
 }
 
-bool Glk::TextGridWindow::writeChar(glui32 ch) {
-    QSize ws(m_CharArray[0].size(), m_CharArray.size());
+void Glk::TextGridWindow::pushStyle(Glk::Style::Type style) {
+    m_Style = StyleManager::isValid(style) ? style : Style::Normal;
+}
 
-    if(m_Cursor.x() < 0 || m_Cursor.y() < 0 || m_Cursor.x() >= ws.width() || m_Cursor.y() >= ws.height())
+bool Glk::TextGridWindow::writeChar(glui32 ch) {
+    if(m_Cursor.x() < 0 || m_Cursor.y() < 0 || m_Cursor.x() >= m_GridSize.width() ||
+       m_Cursor.y() >= m_GridSize.height())
         return false;
 
-    controller()->requestSynchronization();
-
     if(ch == '\n') {
         m_Cursor = QPoint(0, m_Cursor.y() + 1);
         return true;
     }
 
-    m_CharArray[m_Cursor.y()][m_Cursor.x()] = ch;
+    TextGridCell cell{ch, m_Style};
+    TextGridCell& target = m_Cells[std::size_t(m_Cursor.y()) * m_GridSize.width() + m_Cursor.x()];
+    if(target != cell) {
+        target = cell;
+        markDirty(m_Cursor.y());
+    }
     m_Cursor += QPoint(1, 0);
 
-    if(m_Cursor.x() == ws.width()) {
+    if(m_Cursor.x() == m_GridSize.width()) {
         m_Cursor.setX(0);
         m_Cursor += QPoint(0, 1);
     }
@@ -73,28 +81,66 @@ bool Glk::TextGridWindow::writeChar(glui32 ch) {
 }
 
 void Glk::TextGridWindow::resizeGrid(QSize newSize) {
+    newSize = newSize.expandedTo({0, 0});
     QSize oldSize = m_GridSize;
 
-    m_CharArray.resize(std::max(1, newSize.height()));
+    std::size_t oldWidth = oldSize.width();
+    std::size_t newWidth = newSize.width();
+    int keptRows = std::min(oldSize.height(), newSize.height());
+    int keptColumns = std::min(oldSize.width(), newSize.width());
+
+    /* the rows are moved around inside the one buffer, so at most one reallocation happens */
+    m_Cells.resize(std::max(m_Cells.size(), newWidth * newSize.height()));
+
+    if(newWidth > oldWidth) {
+        /* rows move towards the end, so the last one goes first */
+        for(int yy = keptRows - 1; yy >= 0; yy--) {
+            auto source = m_Cells.begin() + yy * oldWidth;
+            auto target = m_Cells.begin() + yy * newWidth;
+            std::move_backward(source, source + keptColumns, target + keptColumns);
+            std::fill(target + keptColumns, target + newWidth, TextGridCell{});
+        }
+    } else if(newWidth < oldWidth) {
+        for(int yy = 1; yy < keptRows; yy++) {
+            auto source = m_Cells.begin() + yy * oldWidth;
+            std::move(source, source + keptColumns, m_Cells.begin() + yy * newWidth);
+        }
+    }
 
-    std::for_each(m_CharArray.begin(), m_CharArray.end(), [newSize](auto& column) {
-        column.resize(std::max(1, newSize.width()));
-    });
+    m_Cells.resize(newWidth * newSize.height());
+    std::fill(m_Cells.begin() + keptRows * newWidth, m_Cells.end(), TextGridCell{});
 
-    for(int yy = oldSize.height(); yy < newSize.height(); yy++) {
-        std::for_each(m_CharArray[yy].begin(), m_CharArray[yy].end(), [](auto& ch) {
-            ch = EMPTY_CHAR;
-        });
-    }
+    m_GridSize = newSize;
 
-    if(newSize.width() > oldSize.width()) {
-        std::for_each(m_CharArray.begin(), m_CharArray.end(), [oldSize, newSize](auto& width) {
-            for(int xx = oldSize.width(); xx < newSize.width(); xx++) {
-                width[xx] = EMPTY_CHAR;
-            }
-        });
+    m_DirtyRows.resize((newSize.height() + ROWS_PER_WORD - 1) / ROWS_PER_WORD);
+    markAllDirty();
+}
+
+std::vector<int> Glk::TextGridWindow::takeDirtyRows() {
+    std::vector<int> rows;
+
+    for(std::size_t ii = 0; ii < m_DirtyRows.size(); ii++) {
+        std::uint64_t word = std::exchange(m_DirtyRows[ii], 0);
+
+        for(int bit = 0; word != 0; bit++, word >>= 1) {
+            int yy = int(ii) * ROWS_PER_WORD + bit;
+            if((word & 1) != 0 && yy < m_GridSize.height())
+                rows.push_back(yy);
+        }
     }
 
-    m_GridSize = newSize;
+    return rows;
 }
 
+void Glk::TextGridWindow::markDirty(int row) {
+    m_DirtyRows[row / ROWS_PER_WORD] |= std::uint64_t(1) << (row % ROWS_PER_WORD);
+
+    /* one request covers every write until the next synchronization */
+    if(!controller()->requiresSynchronization())
+        controller()->requestSynchronization();
+}
+
+void Glk::TextGridWindow::markAllDirty() {
+    /* bits past the last row are ignored when the rows are taken */
+    std::fill(m_DirtyRows.begin(), m_DirtyRows.end(), ~std::uint64_t(0));
+}
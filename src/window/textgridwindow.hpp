@@ -1,11 +1,13 @@
 #ifndef TEXTGRIDWINDOW_HPP
 #define TEXTGRIDWINDOW_HPP
 
+#include <cstdint>
 #include <vector>
 
 #include <QIODevice>
 #include <QPoint>
 
+#include "textgridcell.hpp"
 #include "textgridwindowcontroller.hpp"
 #include "window.hpp"
 
@@ -31,9 +33,12 @@ namespace Glk {
 
             void moveCursor(glui32 x, glui32 y) override;
 
+            void pushStyle(Glk::Style::Type style) override;
 
-            [[nodiscard]] inline const std::vector<std::vector<glui32>>& grid() const {
-                return m_CharArray;
+
+            /// The gridSize().width() cells of a row.
+            [[nodiscard]] inline const TextGridCell* row(int y) const {
+                return m_Cells.data() + std::size_t(y) * m_GridSize.width();
             }
 
             inline void setGridCursor(glui32 xpos, glui32 ypos) {
@@ -46,14 +51,24 @@ namespace Glk {
 
             void resizeGrid(QSize newSize);
 
+            /// Returns the rows changed since the last call and marks the grid clean.
+            [[nodiscard]] std::vector<int> takeDirtyRows();
+
             bool writeChar(glui32 ch);
 
         private:
-            static constexpr glui32 EMPTY_CHAR = ' ';
+            static constexpr int ROWS_PER_WORD = 64;
+
+            void markDirty(int row);
+
+            void markAllDirty();
+
 
-            std::vector<std::vector<glui32>> m_CharArray;
+            std::vector<TextGridCell> m_Cells; /* row major */
+            std::vector<std::uint64_t> m_DirtyRows; /* one bit per row */
             QSize m_GridSize;
             QPoint m_Cursor;
+            Style::Type m_Style;
     };
 }
 
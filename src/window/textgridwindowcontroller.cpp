@@ -10,11 +10,8 @@
 Glk::TextGridWindowController::TextGridWindowController(Glk::PairWindow* winParent, glui32 winRock)
     : WindowController(
     new TextGridWindow(this, winParent, winRock), createWidget()) {
-    widget<TextGridWidget>()->setGrid(window<TextGridWindow>()->grid());
-
     QObject::connect(widget<TextGridWidget>(), &TextGridWidget::resized, [this]() {
         requestSynchronization();
-        QGlk::getMainWindow().eventQueue().requestImmediateSynchronization();
     });
 }
 
@@ -25,8 +22,6 @@ bool Glk::TextGridWindowController::supportsCharInput() const {
 void Glk::TextGridWindowController::synchronize() {
     assert(onEventThread());
 
-    widget<TextGridWidget>()->setGrid(window<TextGridWindow>()->grid());
-
     if(widget()->isVisible() && (widget()->width() != 0 || widget()->height() != 0)) {
         QRect widgetContentsRect = widget()->contentsRect();
         QSize widgetGlkSize(widgetContentsRect.width() / widget<TextGridWidget>()->charWidth(),
@@ -34,11 +29,14 @@ void Glk::TextGridWindowController::synchronize() {
 
         if(widgetGlkSize != window<TextGridWindow>()->gridSize()) {
             window<TextGridWindow>()->resizeGrid(widgetGlkSize);
-            QGlk::getMainWindow().eventQueue().push(event_t{evtype_Arrange, TO_WINID(window())});
+            updateGlkSize();
         }
     }
 
-    WindowController::synchronize();
+    synchronizeGrid();
+
+    /* the widget repaints the changed cells itself, a full update would throw that away */
+    markSynchronized();
 }
 
 QPoint Glk::TextGridWindowController::glkPos(const QPoint& qtPos) const {
@@ -47,7 +45,7 @@ QPoint Glk::TextGridWindowController::glkPos(const QPoint& qtPos) const {
     return qtPos;
 }
 
-QSize Glk::TextGridWindowController::glkSize() const {
+QSize Glk::TextGridWindowController::computeGlkSize() const {
     return window<TextGridWindow>()->gridSize();
 }
 
@@ -73,9 +71,20 @@ QWidget* Glk::TextGridWindowController::createWidget() {
     QWidget* w = nullptr;
 
     Glk::sendTaskToEventThread([&w]() {
-        w = new TextGridWidget;
+        w = new TextGridWidget{QGlk::getMainWindow().textGridStyleManager()};
         w->hide();
     });
 
     return w;
 }
+
+void Glk::TextGridWindowController::synchronizeGrid() {
+    auto win = window<TextGridWindow>();
+    auto widg = widget<TextGridWidget>();
+
+    widg->resizeGrid(win->gridSize());
+
+    /* only the rows written to since last time are copied over and repainted */
+    for(int row : win->takeDirtyRows())
+        widg->setCells(row, 0, win->row(row), win->gridSize().width());
+}
@@ -16,12 +16,15 @@ namespace Glk {
 
             QPoint glkPos(const QPoint& qtPos) const override;
 
-            [[nodiscard]] QSize glkSize() const override;
+            [[nodiscard]] QSize computeGlkSize() const override;
 
             QSize toQtSize(const QSize& glk) const override;
 
         private:
             [[nodiscard]] static QWidget* createWidget();
+
+
+            void synchronizeGrid();
     };
 }
 
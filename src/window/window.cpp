@@ -22,20 +22,17 @@ Glk::Window::Window(Type type, WindowController* winController, std::unique_ptr<
     assert(mp_Stream);
 
     QGlk::getMainWindow().dispatch().registerObject(this);
-    QGlk::getMainWindow().windowList().push_back(this);
-    SPDLOG_DEBUG("{} appended to window list", *this);
+    QGlk::getMainWindow().windowTable().insert(this);
+    SPDLOG_DEBUG("{} added to window table", *this);
 }
 
 Glk::Window::~Window() {
     QGlk::getMainWindow().eventQueue().cleanWindowEvents(TO_WINID(this));
 
-    auto& winList = QGlk::getMainWindow().windowList();
-    if(std::count(winList.begin(), winList.end(), this) == 0) {
-        spdlog::warn("{} not found in window list while removing", *this);
-    } else {
-        winList.remove(this);
-        SPDLOG_DEBUG("{} removed from window list", *this);
-    }
+    if(!QGlk::getMainWindow().windowTable().remove(this))
+        spdlog::warn("{} not found in window table while removing", *this);
+    else
+        SPDLOG_DEBUG("{} removed from window table", *this);
 
     QGlk::getMainWindow().dispatch().unregisterObject(this);
 }
@@ -101,6 +101,9 @@ inline winid_t TO_WINID(Glk::Window* win) {
 }
 
 inline Glk::Window* FROM_WINID(winid_t win) {
+    if(win && Glk::validatingHandles())
+        Glk::validateHandle(win, Glk::Object::Window);
+
     return reinterpret_cast<Glk::Window*>(win);
 }
 
@@ -9,6 +9,7 @@
 #include "textbufferwindowcontroller.hpp"
 #include "textgridwindowcontroller.hpp"
 #include "window.hpp"
+#include "windowwidget.hpp"
 
 Glk::WindowController* Glk::WindowController::createController(glui32 wintype, PairWindow* parent, glui32 rock) {
     switch(wintype) {
@@ -29,6 +30,7 @@ Glk::WindowController::WindowController(Glk::Window* win, QWidget* widg)
     : mp_Window{win},
       mp_Widget{widg},
       m_RequiresSynchronization{false},
+      m_GlkSize{0},
       mp_KeyboardInputProvider{new KeyboardInputProvider{this}},
       mp_MouseInputProvider{new MouseInputProvider{this}},
       mp_HyperlinkInputProvider{new HyperlinkInputProvider{this}} {
@@ -98,6 +100,12 @@ Glk::WindowController::WindowController(Glk::Window* win, QWidget* widg)
                          requestSynchronization();
                      });
 
+    if(auto windowWidget = qobject_cast<WindowWidget*>(widg)) {
+        QObject::connect(windowWidget, &WindowWidget::resized, [this]() {
+            updateGlkSize();
+        });
+    }
+
     requestSynchronization();
 }
 
@@ -135,6 +143,24 @@ void Glk::WindowController::requestSynchronization() {
     QGlk::getMainWindow().eventQueue().requestImmediateSynchronization();
 }
 
+void Glk::WindowController::updateGlkSize() {
+    assert(onEventThread());
+
+    QSize size = computeGlkSize();
+    std::uint64_t packed = (std::uint64_t(std::uint32_t(size.width())) << 32) | std::uint32_t(size.height());
+    std::uint64_t previous = m_GlkSize.exchange(packed, std::memory_order_relaxed);
+
+    /* the first size published is not a change the game needs to hear about */
+    if(previous != packed && previous != 0)
+        QGlk::getMainWindow().eventQueue().pushArrangeEvent(TO_WINID(window()));
+}
+
+void Glk::WindowController::flushOutput() {
+}
+
+void Glk::WindowController::prepareSynchronization() {
+}
+
 void Glk::WindowController::synchronize() {
     assert(onEventThread());
 
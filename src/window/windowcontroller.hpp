@@ -4,6 +4,7 @@
 #include <cassert>
 
 #include <atomic>
+#include <cstdint>
 #include <memory>
 #include <set>
 
@@ -43,6 +44,14 @@ namespace Glk {
                 return m_RequiresSynchronization;
             }
 
+            /// Called on the glk thread just before it asks for synchronization. Windows that record their output
+            ///   can render it here, so less is left for the event thread.
+            virtual void flushOutput();
+
+            /// Called on the event thread for every window about to be synchronized, before any of them is.
+            ///   Windows can use it to start work that does not touch their widget on another thread.
+            virtual void prepareSynchronization();
+
             virtual void synchronize();
 
 
@@ -76,17 +85,37 @@ namespace Glk {
 
             [[nodiscard]] virtual QPoint glkPos(const QPoint& qtPos) const = 0;
 
-            [[nodiscard]] virtual QSize glkSize() const = 0;
+            /// The size in glk units as last worked out on the event thread. Reading it is a single atomic load, so
+            ///   the glk thread never has to ask the widget.
+            [[nodiscard]] inline QSize glkSize() const {
+                std::uint64_t packed = m_GlkSize.load(std::memory_order_relaxed);
+
+                return {int(std::int32_t(packed >> 32)), int(std::int32_t(packed))};
+            }
+
+            /// Works the glk size out again and publishes it, asking for an Arrange event when it changed. Called on
+            ///   the event thread whenever the widget is resized or its font changes, and after synchronization.
+            void updateGlkSize();
 
             [[nodiscard]] virtual QSize toQtSize(const QSize& glk) const = 0;
 
         protected:
             explicit WindowController(Window* win, QWidget* widg);
 
+
+            [[nodiscard]] virtual QSize computeGlkSize() const = 0;
+
+
+            /// Clears the synchronization request without the full widget update synchronize() does.
+            inline void markSynchronized() {
+                m_RequiresSynchronization = false;
+            }
+
         private:
             std::unique_ptr<Window> mp_Window;
             std::unique_ptr<QWidget> mp_Widget;
             std::atomic_bool m_RequiresSynchronization;
+            std::atomic<std::uint64_t> m_GlkSize; /* width in the high half, height in the low one */
 
             KeyboardInputProvider* mp_KeyboardInputProvider;
             MouseInputProvider* mp_MouseInputProvider;
@@ -0,0 +1,116 @@
+#include "windowlayout.hpp"
+
+#include <algorithm>
+
+#include "constraint.hpp"
+#include "pairwindow.hpp"
+
+Glk::WindowLayout Glk::WindowLayout::fromTree(Glk::Window* root) {
+    WindowLayout layout;
+
+    if(root)
+        layout.addNode(root);
+
+    return layout;
+}
+
+std::vector<Glk::WindowLayout::Placement> Glk::WindowLayout::geometry(QSize size) const {
+    std::vector<Placement> placements;
+
+    if(!m_Nodes.empty())
+        place(0, QRect{QPoint{0, 0}, size}, placements);
+
+    return placements;
+}
+
+bool Glk::WindowLayout::operator==(const Glk::WindowLayout& other) const {
+    return m_Nodes == other.m_Nodes;
+}
+
+bool Glk::WindowLayout::Node::operator==(const Glk::WindowLayout::Node& other) const {
+    return widget == other.widget && method == other.method && extent == other.extent && hasKey == other.hasKey &&
+           first == other.first && second == other.second;
+}
+
+int Glk::WindowLayout::addNode(Glk::Window* win) {
+    int index = int(m_Nodes.size());
+    m_Nodes.emplace_back();
+
+    if(win->windowType() != Window::Pair) {
+        m_Nodes[index].widget = win->controller()->widget();
+        return index;
+    }
+
+    auto pair = static_cast<PairWindow*>(win);
+    const WindowArrangement* arrangement = pair->arrangement();
+
+    Node node;
+    node.method = arrangement->method();
+    node.hasKey = pair->keyWindow() != nullptr;
+    node.extent = static_cast<int>(arrangement->size());
+
+    if(node.hasKey && arrangement->isFixed()) {
+        auto size = static_cast<int>(arrangement->size());
+        WindowController* key = pair->keyWindow()->controller();
+
+        node.extent = arrangement->isVertical() ? key->toQtSize({0, size}).height() : key->toQtSize({size, 0}).width();
+    }
+
+    if(pair->firstWindow())
+        node.first = addNode(pair->firstWindow());
+
+    if(pair->secondWindow())
+        node.second = addNode(pair->secondWindow());
+
+    /* the children were added after it, which may have moved it */
+    m_Nodes[index] = node;
+
+    return index;
+}
+
+void Glk::WindowLayout::place(int index, const QRect& rect, std::vector<Placement>& placements) const {
+    const Node& node = m_Nodes[index];
+
+    if(node.widget) {
+        placements.push_back({node.widget, rect});
+        return;
+    }
+
+    /* without a key window the second window takes all the space */
+    if(!node.hasKey) {
+        if(node.first >= 0)
+            place(node.first, QRect{}, placements);
+
+        if(node.second >= 0)
+            place(node.second, rect, placements);
+
+        return;
+    }
+
+    bool vertical = WindowArrangement::isVertical(node.method);
+    int border = WindowArrangement::isBordered(node.method) ? BORDER_SIZE : 0;
+    int available = std::max(0, (vertical ? rect.height() : rect.width()) - border);
+
+    int firstExtent = WindowArrangement::isProportional(node.method) ? available * node.extent / 100 : node.extent;
+    firstExtent = std::clamp(firstExtent, 0, available);
+    int secondExtent = available - firstExtent;
+
+    /* Left and Above put the first window before the second */
+    bool firstLeads = (node.method & 1) == 0;
+    int leadingExtent = firstLeads ? firstExtent : secondExtent;
+
+    QRect leading, trailing;
+    if(vertical) {
+        leading = {rect.left(), rect.top(), rect.width(), leadingExtent};
+        trailing = {rect.left(), rect.top() + leadingExtent + border, rect.width(), available - leadingExtent};
+    } else {
+        leading = {rect.left(), rect.top(), leadingExtent, rect.height()};
+        trailing = {rect.left() + leadingExtent + border, rect.top(), available - leadingExtent, rect.height()};
+    }
+
+    if(node.first >= 0)
+        place(node.first, firstLeads ? leading : trailing, placements);
+
+    if(node.second >= 0)
+        place(node.second, firstLeads ? trailing : leading, placements);
+}
@@ -0,0 +1,62 @@
+#ifndef WINDOWLAYOUT_HPP
+#define WINDOWLAYOUT_HPP
+
+#include <vector>
+
+#include <QRect>
+
+#include "glk.hpp"
+
+class QWidget;
+
+namespace Glk {
+    class Window;
+
+    /// A snapshot of a window tree holding only what its geometry depends on: the arrangement of every pair, with
+    ///   fixed sizes already converted to pixels, and the widget of every other window. The geometry is then a
+    ///   pure function of the snapshot and the size it is laid out in, so it can be worked out again on resize
+    ///   without touching the windows, which belong to the glk thread.
+    class WindowLayout {
+        public:
+            static constexpr int BORDER_SIZE = 5;
+
+            struct Placement {
+                QWidget* widget;
+                QRect rect; /* empty when the window gets no space */
+            };
+
+            WindowLayout() = default;
+
+            /// Takes the snapshot. Only called while the glk thread is blocked.
+            [[nodiscard]] static WindowLayout fromTree(Window* root);
+
+            [[nodiscard]] std::vector<Placement> geometry(QSize size) const;
+
+            [[nodiscard]] bool operator==(const WindowLayout& other) const;
+
+            [[nodiscard]] inline bool operator!=(const WindowLayout& other) const {
+                return !(operator==(other));
+            }
+
+        private:
+            struct Node {
+                QWidget* widget{nullptr}; /* null for pairs */
+                glui32 method{0};
+                int extent{0}; /* pixels for fixed splits, percent for proportional ones */
+                bool hasKey{false};
+                int first{-1};
+                int second{-1};
+
+                [[nodiscard]] bool operator==(const Node& other) const;
+            };
+
+            int addNode(Window* win);
+
+            void place(int index, const QRect& rect, std::vector<Placement>& placements) const;
+
+
+            std::vector<Node> m_Nodes; /* the root comes first */
+    };
+}
+
+#endif //WINDOWLAYOUT_HPP
@@ -24,18 +24,22 @@ std::streamsize Glk::WindowBuf::xsputn(const char* s, std::streamsize count) {
 }
 
 Glk::WindowStream::WindowStream(std::unique_ptr<WindowBuf> dev)
-    : UnicodeStream(nullptr, std::move(dev), Stream::Type::Window, true, 0),
+    : UnicodeStream(std::move(dev), Stream::Type::Window, true, 0),
       mp_EchoStream{nullptr} {}
 
+Glk::WindowStream::~WindowStream() {
+    if(mp_EchoStream)
+        mp_EchoStream->removeObserver(this);
+}
+
 void Glk::WindowStream::setEchoStream(Glk::Stream* echo) {
     if(mp_EchoStream)
-        QObject::disconnect(mp_EchoStream, nullptr, this, nullptr);
+        mp_EchoStream->removeObserver(this);
 
     mp_EchoStream = echo;
 
     if(mp_EchoStream)
-        connect(mp_EchoStream, &Glk::Stream::closed,this, &Glk::WindowStream::onEchoStreamClosed,
-                Qt::DirectConnection);
+        mp_EchoStream->addObserver(this);
 }
 
 void Glk::WindowStream::pushStyle(Style::Type sty) {
@@ -46,7 +50,7 @@ void Glk::WindowStream::pushHyperlink(glui32 linkValue) {
     windowBuf()->window()->pushHyperlink(linkValue);
 }
 
-void Glk::WindowStream::onEchoStreamClosed() {
+void Glk::WindowStream::streamClosed(Glk::Stream* str) {
     mp_EchoStream = nullptr;
 }
 
@@ -29,11 +29,12 @@ namespace Glk {
             Window* mp_Window;
     };
 
-    class WindowStream : public UnicodeStream {
-        Q_OBJECT
+    class WindowStream : public UnicodeStream, private StreamObserver {
         public:
             explicit WindowStream(std::unique_ptr<WindowBuf> winbuf);
 
+            ~WindowStream() override;
+
 
             void writeUnicodeBuffer(buffer::buffer_view<glui32> buf) override;
 
@@ -52,10 +53,10 @@ namespace Glk {
                 return static_cast<WindowBuf*>(streambuf());
             }
 
-        public slots:
-            void onEchoStreamClosed();
-
         private:
+            void streamClosed(Stream* str) override;
+
+
             Glk::Stream* mp_EchoStream;
     };
 }
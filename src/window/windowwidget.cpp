@@ -1,6 +1,7 @@
 #include "windowwidget.hpp"
 
 
+#include <QEvent>
 #include <QKeyEvent>
 #include <QMouseEvent>
 
@@ -27,6 +28,19 @@ bool Glk::WindowWidget::eventFilter(QObject* obj, QEvent* ev) {
     return QWidget::eventFilter(obj, ev);
 }
 
+void Glk::WindowWidget::changeEvent(QEvent* event) {
+    QWidget::changeEvent(event);
+
+    if(event->type() == QEvent::FontChange)
+        emit resized();
+}
+
+void Glk::WindowWidget::resizeEvent(QResizeEvent* event) {
+    QWidget::resizeEvent(event);
+
+    emit resized();
+}
+
 void Glk::WindowWidget::cancelCharInput() {
     assert(onEventThread());
 
@@ -62,7 +62,16 @@ namespace Glk {
 
             void mouseInput(const QPoint& pos);
 
+            /// Emitted when the widget is resized or its font changes, either of which can change its size in
+            ///   glk units.
+            void resized();
+
         protected:
+            void changeEvent(QEvent* event) override;
+
+            void resizeEvent(QResizeEvent* event) override;
+
+
             void installInputFilter(QWidget* widget);
 
 
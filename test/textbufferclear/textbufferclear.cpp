@@ -0,0 +1,51 @@
+/* textbufferclear.cpp: checks that nothing written to a text buffer before
+    glk_window_clear() shows up after it, when the write, the clear and the
+    next write all reach the window in one synchronization. */
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <QString>
+#include <QThread>
+
+#include "glk.hpp"
+
+#include "thread/taskrequest.hpp"
+#include "window/textbufferwidget.hpp"
+#include "window/textbufferwindowcontroller.hpp"
+#include "window/window.hpp"
+
+void glk_main() {
+    winid_t mainwin = glk_window_open(nullptr, 0, 0, wintype_TextBuffer, 1);
+    if(!mainwin) {
+        std::fprintf(stderr, "could not open the text buffer window\n");
+        std::_Exit(EXIT_FAILURE);
+    }
+    glk_set_window(mainwin);
+
+    glk_put_string(const_cast<char*>("a"));
+    glk_window_clear(mainwin);
+    glk_put_string(const_cast<char*>("b"));
+
+    /* synchronizes every window, the text is spliced in once its build on the pool is done */
+    event_t ev;
+    glk_select_poll(&ev);
+
+    QString text;
+    bool synchronized = false;
+    for(int ii = 0; ii < 1000 && !synchronized; ii++) {
+        if(ii > 0)
+            QThread::msleep(10);
+
+        Glk::sendTaskToEventThread([&text, &synchronized, mainwin]() {
+            auto controller = FROM_WINID(mainwin)->controller<Glk::TextBufferWindowController>();
+            synchronized = !controller->requiresSynchronization();
+            text = controller->widget<Glk::TextBufferWidget>()->browser()->document()->toPlainText();
+        });
+    }
+
+    if(text != QStringLiteral("b")) {
+        std::fprintf(stderr, "expected \"b\" in the window, found \"%s\"\n", qUtf8Printable(text));
+        std::_Exit(EXIT_FAILURE);
+    }
+}
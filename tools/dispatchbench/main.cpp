@@ -0,0 +1,105 @@
+#include <map>
+#include <memory>
+#include <vector>
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+
+#include <spdlog/spdlog.h>
+
+#include "arrayregistry.hpp"
+
+namespace {
+    constexpr std::size_t BUFFER_SIZE = 256;
+
+    /* the registry as it was before, with the same lookups per call */
+    class MapRegistry {
+        public:
+            void insert(void* key, gidispatch_rock_t rock) {
+                m_Map[key] = rock;
+            }
+
+            bool take(void* key, gidispatch_rock_t& rock) {
+                if(m_Map.find(key) == m_Map.end())
+                    return false;
+
+                rock = m_Map[key];
+                m_Map.erase(key);
+                return true;
+            }
+
+        private:
+            std::map<void*, gidispatch_rock_t> m_Map;
+    };
+
+    /* registers and unregisters a buffer every cycle, the way a memory stream or a line input request does, while
+     * the other buffers stay registered */
+    template<typename Registry>
+    qint64 run(std::vector<std::unique_ptr<char[]>>& buffers, int live, int cycles) {
+        Registry registry;
+        gidispatch_rock_t rock{};
+        glui32 checksum = 0;
+
+        for(int ii = 0; ii < live; ii++)
+            registry.insert(buffers[ii].get(), rock);
+
+        QElapsedTimer timer;
+        timer.start();
+
+        for(int ii = 0; ii < cycles; ii++) {
+            void* buffer = buffers[live + ii % (buffers.size() - live)].get();
+
+            rock.num = glui32(ii);
+            registry.insert(buffer, rock);
+
+            gidispatch_rock_t taken{};
+            registry.take(buffer, taken);
+            checksum += taken.num;
+        }
+
+        qint64 elapsed = timer.nsecsElapsed();
+
+        /* keeps the loop from being optimized away */
+        if(checksum == glui32(cycles) * 7u + 1u)
+            spdlog::debug("checksum {}", checksum);
+
+        return elapsed;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    spdlog::set_pattern("[%^%L%$] %v");
+
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("qglk-dispatchbench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Compares the retained array registry against the std::map it replaced.");
+    parser.addHelpOption();
+    QCommandLineOption cyclesOption{{"n", "cycles"}, "Number of register/unregister cycles (defaults to 1000000).", "count", "1000000"};
+    parser.addOption(cyclesOption);
+    QCommandLineOption liveOption{{"l", "live"}, "Number of arrays that stay registered (defaults to 16).", "count", "16"};
+    parser.addOption(liveOption);
+    parser.process(app);
+
+    int cycles = parser.value(cyclesOption).toInt();
+    int live = parser.value(liveOption).toInt();
+    if(cycles <= 0 || live < 0)
+        parser.showHelp(1);
+
+    /* separate allocations, so the addresses are spread like those of real buffers */
+    std::vector<std::unique_ptr<char[]>> buffers;
+    for(int ii = 0; ii < live + 64; ii++)
+        buffers.push_back(std::make_unique<char[]>(BUFFER_SIZE));
+
+    spdlog::info("{} cycles with {} arrays registered", cycles, live);
+
+    qint64 mapNs = run<MapRegistry>(buffers, live, cycles);
+    qint64 flatNs = run<Glk::ArrayRegistry>(buffers, live, cycles);
+
+    spdlog::info("{:>6} registry: {:>8.2f} ms, {:>6.1f} ns per cycle", "map", mapNs / 1e6, double(mapNs) / cycles);
+    spdlog::info("{:>6} registry: {:>8.2f} ms, {:>6.1f} ns per cycle", "flat", flatNs / 1e6, double(flatNs) / cycles);
+
+    return 0;
+}
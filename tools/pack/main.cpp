@@ -0,0 +1,317 @@
+#include <algorithm>
+#include <cstring>
+#include <optional>
+#include <tuple>
+#include <vector>
+
+#include <QAudioDecoder>
+#include <QBuffer>
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QEventLoop>
+#include <QFile>
+#include <QImage>
+#include <QSaveFile>
+
+#include <spdlog/spdlog.h>
+
+#include "blorb/resourcepack.hpp"
+
+namespace {
+    constexpr std::uint32_t makeId(char a, char b, char c, char d) {
+        return (std::uint32_t(std::uint8_t(a)) << 24) | (std::uint32_t(std::uint8_t(b)) << 16) |
+               (std::uint32_t(std::uint8_t(c)) << 8) | std::uint32_t(std::uint8_t(d));
+    }
+
+    constexpr std::uint32_t ID_FORM = makeId('F', 'O', 'R', 'M');
+    constexpr std::uint32_t ID_IFRS = makeId('I', 'F', 'R', 'S');
+    constexpr std::uint32_t ID_RIdx = makeId('R', 'I', 'd', 'x');
+    constexpr std::uint32_t ID_Pict = makeId('P', 'i', 'c', 't');
+    constexpr std::uint32_t ID_Snd = makeId('S', 'n', 'd', ' ');
+
+    constexpr int SAMPLE_RATE = 44100;
+    constexpr int CHANNELS = 2;
+    constexpr int SAMPLE_SIZE = 16;
+
+    struct Resource {
+        std::uint32_t usage, number, chunkType, length;
+        const char* data;
+
+        [[nodiscard]] inline int usageRank() const {
+            return usage == ID_Pict ? 0 : (usage == ID_Snd ? 1 : 2);
+        }
+    };
+
+    struct Blob {
+        Glk::Blorb::Pack::Entry entry;
+        QByteArray data;
+    };
+
+    std::uint32_t readId(const QByteArray& file, std::uint32_t pos) {
+        const auto* p = reinterpret_cast<const std::uint8_t*>(file.constData() + pos);
+        return (std::uint32_t(p[0]) << 24) | (std::uint32_t(p[1]) << 16) | (std::uint32_t(p[2]) << 8) | std::uint32_t(p[3]);
+    }
+
+    /* mirrors what gi_blorb reports for each resource, since the fingerprint has to match the one taken at runtime */
+    std::optional<std::vector<Resource>> parseBlorb(const QByteArray& file) {
+        auto size = std::uint32_t(file.size());
+        if(size < 12 || readId(file, 0) != ID_FORM || readId(file, 8) != ID_IFRS)
+            return std::nullopt;
+
+        if(size < 24 || readId(file, 12) != ID_RIdx)
+            return std::nullopt;
+
+        std::uint32_t count = readId(file, 20);
+        if(24 + std::uint64_t(count) * 12 > size)
+            return std::nullopt;
+
+        std::vector<Resource> resources;
+        for(std::uint32_t ii = 0; ii < count; ii++) {
+            std::uint32_t usage = readId(file, 24 + ii * 12);
+            std::uint32_t number = readId(file, 28 + ii * 12);
+            std::uint32_t start = readId(file, 32 + ii * 12);
+            if(std::uint64_t(start) + 8 > size)
+                return std::nullopt;
+
+            std::uint32_t type = readId(file, start);
+            std::uint32_t length = readId(file, start + 4);
+            std::uint32_t dataPos = start + 8;
+            if(type == ID_FORM) {
+                dataPos = start;
+                length += 8;
+            }
+
+            if(std::uint64_t(dataPos) + length > size)
+                return std::nullopt;
+
+            resources.push_back(Resource{usage, number, type, length, file.constData() + dataPos});
+        }
+
+        std::sort(resources.begin(), resources.end(), [](const Resource& a, const Resource& b) {
+            return std::make_tuple(a.usageRank(), a.number) < std::make_tuple(b.usageRank(), b.number);
+        });
+        resources.erase(std::unique(resources.begin(), resources.end(), [](const Resource& a, const Resource& b) {
+            return a.usage == b.usage && a.number == b.number;
+        }), resources.end());
+
+        return resources;
+    }
+
+    Blob imageBlob(const Resource& res, const QImage& img, bool original) {
+        Glk::Blorb::Pack::Entry entry{Glk::Blorb::Pack::Kind::Image, res.number,
+                                      std::uint32_t(img.width()), std::uint32_t(img.height()),
+                                      std::uint32_t(img.bytesPerLine()), original ? 1u : 0u, 0, 0};
+        return Blob{entry, QByteArray{reinterpret_cast<const char*>(img.constBits()), int(img.sizeInBytes())}};
+    }
+
+    std::optional<QByteArray> decodeSound(const Resource& res) {
+        QAudioFormat format;
+        format.setSampleRate(SAMPLE_RATE);
+        format.setChannelCount(CHANNELS);
+        format.setSampleSize(SAMPLE_SIZE);
+        format.setSampleType(QAudioFormat::SignedInt);
+        format.setByteOrder(QAudioFormat::LittleEndian);
+        format.setCodec("audio/pcm");
+
+        QBuffer source;
+        source.setData(QByteArray::fromRawData(res.data, int(res.length)));
+        source.open(QIODevice::ReadOnly);
+
+        QAudioDecoder decoder;
+        decoder.setAudioFormat(format);
+        decoder.setSourceDevice(&source);
+
+        QByteArray pcm;
+        bool failed = false;
+        QEventLoop loop;
+        QObject::connect(&decoder, &QAudioDecoder::bufferReady, [&decoder, &pcm]() {
+            QAudioBuffer buf = decoder.read();
+            pcm.append(static_cast<const char*>(buf.constData()), buf.byteCount());
+        });
+        QObject::connect(&decoder, &QAudioDecoder::finished, &loop, &QEventLoop::quit);
+        QObject::connect(&decoder, QOverload<QAudioDecoder::Error>::of(&QAudioDecoder::error), [&failed, &loop]() {
+            failed = true;
+            loop.quit();
+        });
+
+        decoder.start();
+        loop.exec();
+
+        if(failed || pcm.isEmpty()) {
+            spdlog::warn("Failed to decode sound {}: {}", res.number, decoder.errorString().toStdString());
+            return std::nullopt;
+        }
+
+        return pcm;
+    }
+
+    QByteArray wavFile(const QByteArray& pcm) {
+        auto fn_append32 = [](QByteArray& arr, std::uint32_t val) {
+            for(int ii = 0; ii < 4; ii++)
+                arr.append(char((val >> (8 * ii)) & 0xff));
+        };
+        auto fn_append16 = [](QByteArray& arr, std::uint16_t val) {
+            arr.append(char(val & 0xff));
+            arr.append(char(val >> 8));
+        };
+
+        constexpr std::uint16_t frameSize = CHANNELS * SAMPLE_SIZE / 8;
+
+        QByteArray wav;
+        wav.reserve(44 + pcm.size());
+        wav.append("RIFF", 4);
+        fn_append32(wav, std::uint32_t(36 + pcm.size()));
+        wav.append("WAVEfmt ", 8);
+        fn_append32(wav, 16);
+        fn_append16(wav, 1); /* PCM */
+        fn_append16(wav, CHANNELS);
+        fn_append32(wav, SAMPLE_RATE);
+        fn_append32(wav, SAMPLE_RATE * frameSize);
+        fn_append16(wav, frameSize);
+        fn_append16(wav, SAMPLE_SIZE);
+        wav.append("data", 4);
+        fn_append32(wav, std::uint32_t(pcm.size()));
+        wav.append(pcm);
+
+        return wav;
+    }
+
+    std::uint64_t align(std::uint64_t offset) {
+        return (offset + Glk::Blorb::Pack::ALIGNMENT - 1) / Glk::Blorb::Pack::ALIGNMENT * Glk::Blorb::Pack::ALIGNMENT;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    spdlog::set_pattern("[%^%L%$] %v");
+
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("qglk-pack");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Precompiles the pictures and sounds of a blorb file into a qglk resource pack.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("blorb", "The blorb file to read.");
+    parser.addPositionalArgument("output", "The pack to write (defaults to the blorb path with .qglkpack appended).", "[output]");
+    QCommandLineOption scaleOption{{"s", "scale"}, "Also store pictures scaled by this factor (repeatable, defaults to 0.5 and 2).", "factor"};
+    parser.addOption(scaleOption);
+    QCommandLineOption noScaleOption{"no-scale", "Only store pictures at their native size."};
+    parser.addOption(noScaleOption);
+    parser.process(app);
+
+    const QStringList args = parser.positionalArguments();
+    if(args.size() < 1 || args.size() > 2)
+        parser.showHelp(1);
+
+    std::vector<double> scales{0.5, 2.0};
+    if(parser.isSet(noScaleOption)) {
+        scales.clear();
+    } else if(parser.isSet(scaleOption)) {
+        scales.clear();
+        for(const QString& val : parser.values(scaleOption)) {
+            bool ok;
+            double factor = val.toDouble(&ok);
+            if(!ok || factor <= 0) {
+                spdlog::error("Invalid scale factor '{}'", val.toStdString());
+                return 1;
+            }
+            scales.push_back(factor);
+        }
+    }
+
+    QString blorbPath = args[0];
+    QString outputPath = args.size() > 1 ? args[1] : blorbPath + Glk::Blorb::Pack::SUFFIX;
+
+    QFile blorbFile{blorbPath};
+    if(!blorbFile.open(QIODevice::ReadOnly)) {
+        spdlog::error("Failed to open '{}': {}", blorbPath.toStdString(), blorbFile.errorString().toStdString());
+        return 1;
+    }
+    QByteArray blorb = blorbFile.readAll();
+
+    auto resources = parseBlorb(blorb);
+    if(!resources) {
+        spdlog::error("'{}' is not a valid blorb file", blorbPath.toStdString());
+        return 1;
+    }
+
+    Glk::Blorb::IndexFingerprint fingerprint;
+    std::vector<Blob> blobs;
+    for(const auto& res : *resources) {
+        fingerprint.add(res.usage, res.number, res.chunkType, res.length);
+
+        if(res.usage == ID_Pict) {
+            QImage img = QImage::fromData(reinterpret_cast<const uchar*>(res.data), int(res.length));
+            if(img.isNull()) {
+                spdlog::warn("Failed to decode picture {}", res.number);
+                continue;
+            }
+
+            img = img.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+            blobs.push_back(imageBlob(res, img, true));
+
+            for(double factor : scales) {
+                QSize size = (QSizeF{img.size()} * factor).toSize();
+                if(size.isEmpty() || size == img.size())
+                    continue;
+
+                blobs.push_back(imageBlob(res, img.scaled(size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation), false));
+            }
+        } else if(res.usage == ID_Snd) {
+            auto pcm = decodeSound(res);
+            if(!pcm)
+                continue;
+
+            Glk::Blorb::Pack::Entry entry{Glk::Blorb::Pack::Kind::Sound, res.number, SAMPLE_RATE, CHANNELS,
+                                          CHANNELS * SAMPLE_SIZE / 8, 0, 0, 0};
+            blobs.push_back(Blob{entry, wavFile(*pcm)});
+        }
+    }
+
+    std::sort(blobs.begin(), blobs.end(), [](const Blob& a, const Blob& b) {
+        return std::make_tuple(a.entry.kind, a.entry.number, a.entry.width, a.entry.height) <
+               std::make_tuple(b.entry.kind, b.entry.number, b.entry.width, b.entry.height);
+    });
+
+    Glk::Blorb::Pack::Header header{};
+    std::memcpy(header.magic, Glk::Blorb::Pack::MAGIC, sizeof(header.magic));
+    header.version = Glk::Blorb::Pack::VERSION;
+    header.fingerprint = fingerprint.value();
+    header.entryCount = std::uint32_t(blobs.size());
+
+    std::uint64_t offset = align(sizeof(header) + blobs.size() * sizeof(Glk::Blorb::Pack::Entry));
+    for(auto& blob : blobs) {
+        blob.entry.offset = offset;
+        blob.entry.length = std::uint64_t(blob.data.size());
+        offset = align(offset + blob.entry.length);
+    }
+
+    QSaveFile output{outputPath};
+    if(!output.open(QIODevice::WriteOnly)) {
+        spdlog::error("Failed to open '{}': {}", outputPath.toStdString(), output.errorString().toStdString());
+        return 1;
+    }
+
+    auto fn_pad = [&output]() {
+        static const char zeros[Glk::Blorb::Pack::ALIGNMENT] = {};
+        output.write(zeros, qint64(align(std::uint64_t(output.pos())) - std::uint64_t(output.pos())));
+    };
+
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for(const auto& blob : blobs)
+        output.write(reinterpret_cast<const char*>(&blob.entry), sizeof(blob.entry));
+
+    for(const auto& blob : blobs) {
+        fn_pad();
+        output.write(blob.data);
+    }
+
+    qint64 size = output.pos();
+    if(!output.commit()) {
+        spdlog::error("Failed to write '{}': {}", outputPath.toStdString(), output.errorString().toStdString());
+        return 1;
+    }
+
+    spdlog::info("Wrote {} entries to '{}' ({} bytes)", blobs.size(), outputPath.toStdString(), size);
+
+    return 0;
+}
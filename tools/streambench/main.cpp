@@ -0,0 +1,144 @@
+#include <memory>
+#include <streambuf>
+#include <string_view>
+#include <vector>
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+
+#include <spdlog/spdlog.h>
+
+extern "C" {
+#include "glk.h"
+}
+
+#include "stream/memoryarea.hpp"
+
+namespace {
+    constexpr std::size_t BUFFER_SIZE = 1024;
+
+    constexpr std::string_view SAMPLE = "You are standing in an open field west of a white house, with a boarded "
+                                        "front door. There is a small mailbox here.";
+
+    /* the path a character took before: a virtual call into the stream, then the streambuf */
+    class MemoryStreambuf final : public std::streambuf {
+        public:
+            explicit MemoryStreambuf(Glk::MemoryArea& area_) : m_Area{area_} {}
+
+        protected:
+            std::streamsize xsputn(const char* s, std::streamsize count) final {
+                return std::streamsize(m_Area.write(s, std::size_t(count)));
+            }
+
+            pos_type seekpos(pos_type pos, std::ios_base::openmode) final {
+                m_Area.setPosition(pos);
+                return m_Area.position();
+            }
+
+        private:
+            Glk::MemoryArea& m_Area;
+    };
+
+    class Sink {
+        public:
+            virtual ~Sink() = default;
+
+            virtual void writeBuffer(const char* buf, glui32 len) = 0;
+            virtual void rewind() = 0;
+
+            glui32 writeCount{0};
+    };
+
+    class StreambufSink final : public Sink {
+        public:
+            explicit StreambufSink(std::streambuf* buf_) : mp_Streambuf{buf_} {}
+
+            void writeBuffer(const char* buf, glui32 len) final {
+                writeCount += glui32(mp_Streambuf->sputn(buf, len));
+            }
+
+            void rewind() final {
+                mp_Streambuf->pubseekpos(0);
+            }
+
+        private:
+            std::streambuf* mp_Streambuf;
+    };
+
+    /* prints the sample one character at a time, the way glulxe prints a decoded string with glk_put_char */
+    qint64 runStreambuf(Glk::MemoryArea& area, int strings) {
+        MemoryStreambuf streambuf{area};
+        std::unique_ptr<Sink> sink = std::make_unique<StreambufSink>(&streambuf);
+
+        QElapsedTimer timer;
+        timer.start();
+
+        for(int ii = 0; ii < strings; ii++) {
+            sink->rewind();
+            for(char ch : SAMPLE)
+                sink->writeBuffer(&ch, 1);
+        }
+
+        qint64 elapsed = timer.nsecsElapsed();
+
+        /* keeps the loop from being optimized away */
+        if(sink->writeCount == 1u)
+            spdlog::debug("write count {}", sink->writeCount);
+
+        return elapsed;
+    }
+
+    qint64 runInline(Glk::MemoryArea& area, int strings) {
+        glui32 writeCount = 0;
+
+        QElapsedTimer timer;
+        timer.start();
+
+        for(int ii = 0; ii < strings; ii++) {
+            area.setPosition(0);
+            for(char ch : SAMPLE)
+                writeCount += glui32(area.put(ch));
+        }
+
+        qint64 elapsed = timer.nsecsElapsed();
+
+        if(writeCount == 1u)
+            spdlog::debug("write count {}", writeCount);
+
+        return elapsed;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    spdlog::set_pattern("[%^%L%$] %v");
+
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("qglk-streambench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Compares writing characters to a memory stream directly against going through "
+                                     "the streambuf.");
+    parser.addHelpOption();
+    QCommandLineOption stringsOption{{"n", "strings"}, "Number of strings printed (defaults to 1000000).", "count", "1000000"};
+    parser.addOption(stringsOption);
+    parser.process(app);
+
+    int strings = parser.value(stringsOption).toInt();
+    if(strings <= 0)
+        parser.showHelp(1);
+
+    std::vector<char> buffer(BUFFER_SIZE);
+    Glk::MemoryArea area{buffer.data(), buffer.size(), true};
+
+    spdlog::info("{} strings of {} characters", strings, SAMPLE.size());
+
+    qint64 streambufNs = runStreambuf(area, strings);
+    qint64 inlineNs = runInline(area, strings);
+
+    double chars = double(strings) * SAMPLE.size();
+    spdlog::info("{:>9}: {:>8.2f} ms, {:>6.2f} ns per character", "streambuf", streambufNs / 1e6, streambufNs / chars);
+    spdlog::info("{:>9}: {:>8.2f} ms, {:>6.2f} ns per character", "inline", inlineNs / 1e6, inlineNs / chars);
+
+    return 0;
+}
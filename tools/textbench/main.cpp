@@ -0,0 +1,136 @@
+#include <functional>
+#include <vector>
+
+#include <QAbstractTextDocumentLayout>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QGuiApplication>
+#include <QImage>
+#include <QPainter>
+#include <QTextBlockFormat>
+#include <QTextCharFormat>
+#include <QTextCursor>
+#include <QTextDocument>
+
+#include <spdlog/spdlog.h>
+
+#include "window/textbufferlayout.hpp"
+
+namespace {
+    constexpr int VIEWPORT_HEIGHT = 600;
+    constexpr int PARAGRAPHS_PER_SYNC = 20;
+    constexpr int PAINT_ROUNDS = 50;
+
+    const char* const SAMPLE_TEXT =
+            "You are standing in an open field west of a white house, with a boarded front door. There is a small "
+            "mailbox here. The grass is damp underfoot and a narrow path winds north between the trees, where the "
+            "light fades into a thick and silent forest.";
+
+    struct Result {
+        qint64 appendNs;
+        qint64 paintNs;
+        qint64 resizeNs;
+    };
+
+    qint64 measure(const std::function<void()>& fn) {
+        QElapsedTimer timer;
+        timer.start();
+        fn();
+        return timer.nsecsElapsed();
+    }
+
+    /* paints the bottom of the document, which is where a text buffer is looked at */
+    void paintBottom(QTextDocument& doc, QImage& target) {
+        QAbstractTextDocumentLayout* layout = doc.documentLayout();
+        qreal bottom = layout->documentSize().height();
+
+        QPainter painter{&target};
+        painter.translate(0, VIEWPORT_HEIGHT - bottom);
+
+        QAbstractTextDocumentLayout::PaintContext context;
+        context.clip = QRectF{0, bottom - VIEWPORT_HEIGHT, qreal(target.width()), qreal(VIEWPORT_HEIGHT)};
+        layout->draw(&painter, context);
+    }
+
+    Result run(bool fast, int paragraphs, int width) {
+        QTextDocument doc;
+        doc.setUndoRedoEnabled(false);
+        if(fast)
+            doc.setDocumentLayout(new Glk::TextBufferLayout{&doc});
+        doc.setTextWidth(width);
+
+        /* styled like the default text buffer styles: justified paragraphs with the odd emphasized run */
+        QTextBlockFormat blockFormat;
+        blockFormat.setAlignment(Qt::AlignJustify);
+        blockFormat.setBottomMargin(6);
+
+        QTextCharFormat normal;
+        QTextCharFormat emphasized;
+        emphasized.setFontWeight(QFont::Bold);
+
+        QImage target{width, VIEWPORT_HEIGHT, QImage::Format_ARGB32_Premultiplied};
+        Result result{};
+
+        result.appendNs = measure([&]() {
+            QTextCursor cur{&doc};
+            for(int ii = 0; ii < paragraphs; ii += PARAGRAPHS_PER_SYNC) {
+                cur.beginEditBlock();
+                cur.movePosition(QTextCursor::End);
+                for(int jj = ii; jj < ii + PARAGRAPHS_PER_SYNC && jj < paragraphs; jj++) {
+                    cur.insertBlock(blockFormat);
+                    cur.insertText(QStringLiteral("%1. ").arg(jj), emphasized);
+                    cur.insertText(SAMPLE_TEXT, normal);
+                }
+                cur.endEditBlock();
+
+                /* the view asks for the new size after every sync to keep its scroll bar up to date */
+                doc.documentLayout()->documentSize();
+            }
+        });
+
+        result.paintNs = measure([&]() {
+            for(int ii = 0; ii < PAINT_ROUNDS; ii++)
+                paintBottom(doc, target);
+        }) / PAINT_ROUNDS;
+
+        result.resizeNs = measure([&]() {
+            doc.setTextWidth(width * 3 / 4);
+            paintBottom(doc, target);
+            doc.setTextWidth(width);
+            paintBottom(doc, target);
+        });
+
+        return result;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    spdlog::set_pattern("[%^%L%$] %v");
+
+    QGuiApplication app(argc, argv);
+    QGuiApplication::setApplicationName("qglk-textbench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Compares Qt's document layout against the qglk text buffer layout.");
+    parser.addHelpOption();
+    QCommandLineOption paragraphsOption{{"n", "paragraphs"}, "Number of paragraphs to append (defaults to 5000).", "count", "5000"};
+    parser.addOption(paragraphsOption);
+    QCommandLineOption widthOption{{"w", "width"}, "Width of the view in pixels (defaults to 800).", "pixels", "800"};
+    parser.addOption(widthOption);
+    parser.process(app);
+
+    int paragraphs = parser.value(paragraphsOption).toInt();
+    int width = parser.value(widthOption).toInt();
+    if(paragraphs <= 0 || width <= 0)
+        parser.showHelp(1);
+
+    spdlog::info("{} paragraphs at {}px, appended {} per sync", paragraphs, width, PARAGRAPHS_PER_SYNC);
+
+    for(bool fast : {false, true}) {
+        Result result = run(fast, paragraphs, width);
+        spdlog::info("{:>6} layout: append {:>8.2f} ms, paint {:>6.3f} ms, resize {:>8.2f} ms",
+                     fast ? "fast" : "qt", result.appendNs / 1e6, result.paintNs / 1e6, result.resizeNs / 1e6);
+    }
+
+    return 0;
+}